@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <functional>
+#include <atomic>
+
+#include "Supervisor.h"
+
+#define CALLS 200
+
+static std::atomic<size_t> allocations(0);
+
+/**
+ * Counting replacement of the global operator new, so the check can tell how many allocations each query makes.
+ */
+void* operator new(size_t size) {
+    allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * Runs a query CALLS times, after a first round of the same calls that sizes the reused buffers, and prints the
+ * allocations and the time per call.\n\n
+ *
+ * @param name Name of the query.
+ * @param query The query, given the number of the call.
+ * @param limit Largest number of allocations per call allowed (negative for no limit).
+ *
+ * @return True if the query is within the limit, false otherwise.
+ */
+static bool check(const char* name, const std::function<long(int)>& query, double limit) {
+    for (int i = 0; i < CALLS; i++)
+        query(i);
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    long result = 0;
+    for (int i = 0; i < CALLS; i++)
+        result += query(i);
+    auto end = std::chrono::steady_clock::now();
+
+    double perCall = (double) (allocations - before) / CALLS;
+    bool ok = limit < 0 || perCall <= limit;
+    std::printf("%-26s allocations/call %8.1f  %.3f ms/call  (%ld)%s\n", name, perCall,
+                std::chrono::duration<double, std::milli>(end - start).count() / CALLS, result, ok ? "" : "  FAILED");
+    return ok;
+}
+
+/**
+ * Checks that the augmenting-path searches of the flow queries do not allocate once their buffers are sized: the
+ * max flow and min cost of the graph and the max flow of the bridge index must make no allocation per call. The
+ * chain contraction splices edges into its reduced graph for each query, so it is only reported. The station flows
+ * are computed first, so the warm-up thread of the supervisor does not allocate during the check. Must be run from a
+ * directory next to data, like the program.\n\n
+ *
+ * @return 0 if every query is within its limit, 1 otherwise.
+ */
+int main() {
+    Supervisor supervisor;
+    for (const Station& station : supervisor.getStations())
+        supervisor.maxStationFlow(station.getName());
+
+    Graph graph = supervisor.originalGraph();
+    Graph contracted = supervisor.originalGraph();
+    BridgeIndex bridgeIndex(graph);
+    ChainContraction contraction(contracted);
+    int n = (int) graph.getVertexSet().size();
+
+    bool ok = check("Graph::maxFlow", [&](int i) { return graph.maxFlow(i % n, (i * 7 + 3) % n); }, 0);
+    ok &= check("Graph::minCost", [&](int i) { return graph.minCost(i % n, (i * 7 + 3) % n); }, 0);
+    ok &= check("BridgeIndex::maxFlow", [&](int i) { return bridgeIndex.maxFlow(i % n, (i * 7 + 3) % n); }, 0);
+    ok &= check("ChainContraction::minCost", [&](int i) { return contraction.minCost(i % n, (i * 7 + 3) % n); }, -1);
+    return ok ? 0 : 1;
+}
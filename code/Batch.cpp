@@ -0,0 +1,124 @@
+#include "Batch.h"
+
+/**
+ * Non-interactive mode: answers a single command given on the command line and writes plain tab separated lines to
+ * the standard output, so the results can be consumed by other tools.\n\n
+ *
+ * @param supervisor The supervisor of the network.
+ */
+Batch::Batch(Supervisor* supervisor): supervisor(supervisor) {}
+
+/**
+ * Runs a command.\n\n
+ *
+ * @param args The command and its arguments.
+ *
+ * @return The exit status of the program.
+ */
+int Batch::run(const std::vector<std::string>& args) {
+    if (args.size() == 3 && args[0] == "routes")
+        return routes(args[1], args[2]);
+    if (args.size() == 4 && args[0] == "k-routes")
+        return cheapestRoutes(args[1], args[2], args[3]);
+    if ((args.size() == 1 || args.size() == 2) && args[0] == "flow-matrix")
+        return flowMatrix(args.size() == 2 ? args[1] : "0");
+    return usage();
+}
+
+/**
+ * Writes the routes followed by the maximum number of trains between two stations at the minimum cost, one per
+ * line: number of trains, cost of one train and the stations of the route separated by " -> ". The minimum cost is
+ * the sum of the number of trains times the cost of one train over all the lines, as in the menu.\n\n
+ *
+ * @param source The name of the source station.
+ * @param target The name of the target station.
+ *
+ * @return The exit status of the program.
+ *
+ * @par Time complexity
+ * O(V * E² * log(V)), where V is the number of vertexes and E the number of edges in the graph
+ */
+int Batch::routes(const std::string& source, const std::string& target) {
+    const auto& ids = supervisor->getId();
+    if (!ids.count(source) || !ids.count(target) || source == target) {
+        std::cerr << "Unknown stations: " << source << ", " << target << '\n';
+        return 1;
+    }
+
+    const Graph& graph = supervisor->getGraph();
+    for (const Route& route : supervisor->routes(false, ids.at(source), ids.at(target))) {
+        std::cout << route.trains << '\t' << route.cost << '\t';
+        for (unsigned int i = 0; i < route.stations.size(); i++)
+            std::cout << (i ? " -> " : "") << graph.findVertex(route.stations[i])->getStation().getName();
+        std::cout << '\n';
+    }
+    return 0;
+}
+
+/**
+ * Writes the k cheapest alternative routes between two stations, one per line in the same format as routes: number
+ * of trains the route can take, cost of one train and the stations of the route separated by " -> ".\n\n
+ *
+ * @param source The name of the source station.
+ * @param target The name of the target station.
+ * @param k The number of routes wanted.
+ *
+ * @return The exit status of the program.
+ *
+ * @par Time complexity
+ * O(k * V * (V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph
+ */
+int Batch::cheapestRoutes(const std::string& source, const std::string& target, const std::string& k) {
+    const auto& ids = supervisor->getId();
+    if (!ids.count(source) || !ids.count(target) || source == target) {
+        std::cerr << "Unknown stations: " << source << ", " << target << '\n';
+        return 1;
+    }
+    if (k.empty() || k.size() > 4 || k.find_first_not_of("0123456789") != std::string::npos) return usage();
+
+    const Graph& graph = supervisor->getGraph();
+    for (const Route& route : supervisor->cheapestRoutes(false, ids.at(source), ids.at(target), std::stoi(k))) {
+        std::cout << route.trains << '\t' << route.cost << '\t';
+        for (unsigned int i = 0; i < route.stations.size(); i++)
+            std::cout << (i ? " -> " : "") << graph.findVertex(route.stations[i])->getStation().getName();
+        std::cout << '\n';
+    }
+    return 0;
+}
+
+/**
+ * Builds the flow matrix of the intact network offline, so the max flow between two stations and the pairs of
+ * stations that require the most trains are answered with a lookup afterwards.\n\n
+ *
+ * @param threads The number of threads, 0 for the number of cores.
+ *
+ * @return The exit status of the program.
+ *
+ * @par Time complexity
+ * O(V² * (D + C * E²) / p), where V is the number of stations, D the depth of the bridge forest, C and E the vertexes
+ * and edges of the largest 2-edge-connected component and p the threads
+ */
+int Batch::flowMatrix(const std::string& threads) {
+    if (threads.empty() || threads.size() > 4 || threads.find_first_not_of("0123456789") != std::string::npos) return usage();
+    if (!supervisor->buildFlowMatrix(std::stoi(threads))) {
+        std::cerr << "Could not build " << FLOW_MATRIX << '\n';
+        return 1;
+    }
+    std::cout << FLOW_MATRIX << '\n';
+    return 0;
+}
+
+/**
+ * Writes the commands available.\n\n
+ *
+ * @return The exit status of the program.
+ */
+int Batch::usage() {
+    std::cerr << "Usage:\n"
+                 "  DA                            interactive menu\n"
+                 "  DA routes <source> <target>   train routes of the max flow at minimum cost\n"
+                 "  DA k-routes <source> <target> <k>\n"
+                 "                                the k cheapest alternative routes between two stations\n"
+                 "  DA flow-matrix [threads]      precompute the max flow of every pair of stations\n";
+    return 2;
+}
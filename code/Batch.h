@@ -0,0 +1,26 @@
+#ifndef DA_BATCH_H
+#define DA_BATCH_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Supervisor.h"
+
+class Batch {
+public:
+    explicit Batch(Supervisor* supervisor);
+
+    int run(const std::vector<std::string>& args);
+
+private:
+    Supervisor* supervisor;
+
+    int routes(const std::string& source, const std::string& target);
+    int cheapestRoutes(const std::string& source, const std::string& target, const std::string& k);
+    int flowMatrix(const std::string& threads);
+
+    static int usage();
+};
+
+#endif //DA_BATCH_H
@@ -0,0 +1,492 @@
+#include "BridgeIndex.h"
+
+BridgeIndex::BridgeIndex() = default;
+
+/**
+ * Builds the bridge index of an undirected graph: its bridges, its 2-edge-connected components and the bridge
+ * tree (forest) that links those components.\n\n
+ *
+ * @param graph The graph to index.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+BridgeIndex::BridgeIndex(const Graph& graph) {
+    vertexSet = graph.getVertexSet();
+    for (Vertex* v : vertexSet)
+        adj.push_back(v->getAdj());
+
+    findBridges();
+    findComponents();
+    buildBridgeTree();
+}
+
+/**
+ * Finds the bridges, the components and the bridge forest again from the segments kept by the index.\n\n
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+void BridgeIndex::reindex() {
+    bridges.clear();
+    members.clear();
+    findBridges();
+    findComponents();
+    buildBridgeTree();
+}
+
+/**
+ * Updates the index after a segment was added to the graph. A segment inside a 2-edge-connected component changes
+ * neither the bridges nor the components, so it is only added to the adjacency; otherwise the segment closes a cycle
+ * through bridges (or joins two trees) and the index is built again.\n\n
+ *
+ * @param edge One direction of the new segment.
+ *
+ * @par Time complexity
+ * O(1) inside a component, otherwise O(V + E), where V is the number of vertexes and E the number of edges.
+ */
+void BridgeIndex::addSegment(Edge* edge) {
+    int u = edge->getOrig()->getId(), v = edge->getDest()->getId();
+    adj[u].push_back(edge);
+    adj[v].push_back(edge->getReverse());
+    if (component[u] != component[v])
+        reindex();
+}
+
+/**
+ * Updates the index before a segment is removed from the graph. Removing a bridge keeps every component and only
+ * splits its tree: the side away from the root becomes a tree of its own. Removing any other segment may split its
+ * component, so the index is built again.\n\n
+ *
+ * @param edge One direction of the segment (still in the graph).
+ *
+ * @par Time complexity
+ * O(C + B) for a bridge, where C and B are the vertexes and bridges of the split side, otherwise O(V + E), where V is
+ * the number of vertexes and E the number of edges.
+ */
+void BridgeIndex::removeSegment(Edge* edge) {
+    for (Edge* e : {edge, edge->getReverse()}) {
+        std::vector<Edge*>& edges = adj[e->getOrig()->getId()];
+        edges.erase(std::find(edges.begin(), edges.end(), e));
+    }
+    if (!isBridge(edge)) {
+        reindex();
+        return;
+    }
+
+    bridges.erase(edge);
+    bridges.erase(edge->getReverse());
+    int root = component[edge->getDest()->getId()];
+    if (parentEdge[root] != edge)
+        root = component[edge->getOrig()->getId()];
+    parent[root] = -1;
+    parentEdge[root] = nullptr;
+
+    int shift = depth[root];
+    std::queue<int> queue;
+    queue.push(root);
+    while (!queue.empty()) {
+        int c = queue.front();
+        queue.pop();
+        tree[c] = root;
+        depth[c] -= shift;
+        for (int v : members[c])
+            for (Edge* e : adj[v])
+                if (isBridge(e) && parent[component[e->getDest()->getId()]] == c)
+                    queue.push(component[e->getDest()->getId()]);
+    }
+}
+
+/**
+ * Checks if an edge is a bridge, that is, if removing its segment disconnects the network.\n\n
+ *
+ * @param edge The edge to check (either direction of the segment).
+ *
+ * @return True if the edge is a bridge, false otherwise.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+bool BridgeIndex::isBridge(const Edge* edge) const {
+    return bridges.find(edge) != bridges.end();
+}
+
+/**
+ * @param id The identifier of the vertex.
+ * @return The 2-edge-connected component the vertex belongs to.
+ */
+int BridgeIndex::getComponent(int id) const {
+    return component[id];
+}
+
+/**
+ * @param id The identifier of the vertex.
+ * @return The connected component (tree of the bridge forest) the vertex belongs to.
+ */
+int BridgeIndex::getTree(int id) const {
+    return tree[component[id]];
+}
+
+/**
+ * @return The number of 2-edge-connected components.
+ */
+unsigned int BridgeIndex::getComponentCount() const {
+    return members.size();
+}
+
+/**
+ * Finds every bridge of the graph with an iterative version of Tarjan's algorithm. The edge used to enter a vertex
+ * is skipped by pointer (and not by vertex), so parallel segments between two stations are never taken as bridges.\n\n
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+void BridgeIndex::findBridges() {
+    int n = vertexSet.size(), time = 0;
+    std::vector<int> discovery(n, -1), low(n, 0);
+    std::vector<Edge*> entry(n, nullptr);
+    std::vector<unsigned int> next(n, 0);
+
+    for (int root = 0; root < n; root++) {
+        if (discovery[root] != -1) continue;
+
+        std::stack<int> stack;
+        stack.push(root);
+        discovery[root] = low[root] = time++;
+
+        while (!stack.empty()) {
+            int v = stack.top();
+
+            if (next[v] < adj[v].size()) {
+                Edge* e = adj[v][next[v]++];
+                if (entry[v] != nullptr && e == entry[v]->getReverse()) continue;
+                int w = e->getDest()->getId();
+                if (discovery[w] == -1) {
+                    discovery[w] = low[w] = time++;
+                    entry[w] = e;
+                    stack.push(w);
+                }
+                else
+                    low[v] = std::min(low[v], discovery[w]);
+            }
+            else {
+                stack.pop();
+                if (entry[v] == nullptr) continue;
+                int u = entry[v]->getOrig()->getId();
+                low[u] = std::min(low[u], low[v]);
+                if (low[v] > discovery[u]) {
+                    bridges.insert(entry[v]);
+                    bridges.insert(entry[v]->getReverse());
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Labels each vertex with its 2-edge-connected component, by running a BFS that never crosses a bridge.\n\n
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+void BridgeIndex::findComponents() {
+    int n = vertexSet.size();
+    component.assign(n, -1);
+
+    for (int root = 0; root < n; root++) {
+        if (component[root] != -1) continue;
+
+        int c = members.size();
+        members.emplace_back();
+        component[root] = c;
+
+        std::queue<int> queue;
+        queue.push(root);
+        while (!queue.empty()) {
+            int v = queue.front();
+            queue.pop();
+            members[c].push_back(v);
+            for (Edge* e : adj[v]) {
+                int w = e->getDest()->getId();
+                if (component[w] == -1 && !isBridge(e)) {
+                    component[w] = c;
+                    queue.push(w);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Roots every tree of the bridge forest, whose nodes are the 2-edge-connected components and whose edges are the
+ * bridges. For each component it stores its parent, the bridge leading to it (from the parent's side), its depth
+ * and the tree it belongs to.\n\n
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+void BridgeIndex::buildBridgeTree() {
+    int m = members.size();
+    parent.assign(m, -1);
+    parentEdge.assign(m, nullptr);
+    depth.assign(m, 0);
+    tree.assign(m, -1);
+
+    for (int root = 0; root < m; root++) {
+        if (tree[root] != -1) continue;
+
+        tree[root] = root;
+        std::queue<int> queue;
+        queue.push(root);
+        while (!queue.empty()) {
+            int c = queue.front();
+            queue.pop();
+            for (int v : members[c])
+                for (Edge* e : adj[v]) {
+                    if (!isBridge(e)) continue;
+                    int d = component[e->getDest()->getId()];
+                    if (tree[d] != -1) continue;
+                    tree[d] = root;
+                    parent[d] = c;
+                    parentEdge[d] = e;
+                    depth[d] = depth[c] + 1;
+                    queue.push(d);
+                }
+        }
+    }
+}
+
+/**
+ * Finds the shortest augmenting path between two vertexes of the same 2-edge-connected component, using a BFS that
+ * never leaves that component.\n\n
+ *
+ * @param src A pointer to the source vertex.
+ * @param dest A pointer to the target vertex.
+ *
+ * @return True if a path from the source to the target was found, false otherwise.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the component.
+ */
+bool BridgeIndex::findBlockAugmentingPath(Vertex* src, Vertex* dest) {
+    int c = component[src->getId()];
+    for (int v : members[c])
+        vertexSet[v]->setVisited(false);
+
+    src->setVisited(true);
+
+    searchQueue.clear();
+    searchQueue.push_back(src);
+
+    for (size_t head = 0; head < searchQueue.size() && !dest->isVisited(); head++) {
+        Vertex* v = searchQueue[head];
+
+        for (Edge* e : adj[v->getId()]) {
+            Vertex* w = e->getDest();
+            if (component[w->getId()] != c) continue;
+            if (!w->isVisited() && e->getResidualCapacity() > 0) {
+                w->setVisited(true);
+                w->setPath(e);
+                searchQueue.push_back(w);
+            }
+        }
+    }
+
+    return dest->isVisited();
+}
+
+/**
+ * Calculates the max flow between two vertexes of the same 2-edge-connected component, using the Edmonds-Karp
+ * algorithm on that component only (no simple path between them can leave it). The search stops as soon as the
+ * flow reaches the given bound, since the caller never needs more than that.\n\n
+ *
+ * @param src A pointer to the source vertex.
+ * @param dest A pointer to the target vertex.
+ * @param bound Flow value after which the search can stop.
+ *
+ * @return The minimum between the max flow inside the component and the bound.
+ *
+ * @par Time complexity
+ * O(V * E²), where V is the number of vertexes and E the number of edges in the component.
+ */
+int BridgeIndex::blockFlow(Vertex* src, Vertex* dest, int bound) {
+    int c = component[src->getId()];
+    for (int v : members[c])
+        for (Edge* e : adj[v])
+            e->setResidualCapacity(e->getCapacity());
+
+    int flow = 0;
+    while (flow < bound && findBlockAugmentingPath(src, dest)) {
+        int f = INF;
+        for (Vertex* v = dest; v != src; v = v->getPath()->getOrig())
+            f = std::min(f, v->getPath()->getResidualCapacity());
+        for (Vertex* v = dest; v != src; v = v->getPath()->getOrig()) {
+            Edge* e = v->getPath();
+            e->setResidualCapacity(e->getResidualCapacity() - f);
+            e->getReverse()->setResidualCapacity(e->getReverse()->getResidualCapacity() + f);
+        }
+        flow += f;
+    }
+    return std::min(flow, bound);
+}
+
+/**
+ * Calculates the max flow between two stations using the bridge forest. Every path between stations in different
+ * 2-edge-connected components crosses the same bridges and components, so the flow is the minimum between the
+ * capacity of those bridges and the flow inside each crossed component (from the vertex where the path enters it
+ * to the vertex where it leaves). Components entered and left through the same vertex (e.g. stations of branch
+ * lines) need no flow computation at all, so when the bottleneck is a bridge the answer comes straight from the
+ * index; otherwise max flow only runs on the relevant components.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The maximum flow from the source vertex to the target vertex.
+ *
+ * @par Time complexity
+ * O(D + C * E²), where D is the depth of the bridge forest and C, E the vertexes and edges of the crossed components.
+ */
+int BridgeIndex::maxFlow(int source, int target) {
+    int n = vertexSet.size();
+    if (source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return 0;
+
+    int cs = component[source], ct = component[target];
+    if (tree[cs] != tree[ct])
+        return 0;
+
+    Vertex* a = vertexSet[source];
+    Vertex* b = vertexSet[target];
+    std::vector<std::pair<Vertex*, Vertex*>>& segments = pathSegments;
+    segments.clear();
+    int bound = INF;
+
+    while (cs != ct) {
+        if (depth[cs] >= depth[ct]) {
+            Edge* e = parentEdge[cs];
+            segments.emplace_back(a, e->getDest());
+            bound = std::min(bound, e->getCapacity());
+            a = e->getOrig();
+            cs = parent[cs];
+        }
+        else {
+            Edge* e = parentEdge[ct];
+            segments.emplace_back(b, e->getDest());
+            bound = std::min(bound, e->getCapacity());
+            b = e->getOrig();
+            ct = parent[ct];
+        }
+    }
+    segments.emplace_back(a, b);
+
+    for (const auto& segment : segments) {
+        if (bound == 0) break;
+        if (segment.first != segment.second)
+            bound = blockFlow(segment.first, segment.second, bound);
+    }
+    return bound;
+}
+
+/**
+ * Calculates the max flow between two vertexes of the same 2-edge-connected component and a minimum cut that
+ * separates them: the vertexes of the component still reachable from the source once the flow is maximum.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ * @param side Vector where the vertexes of the source side of the cut are stored.
+ *
+ * @return The maximum flow from the source vertex to the target vertex, or 0 if they are in different components.
+ *
+ * @par Time complexity
+ * O(C * E²), where C and E are the vertexes and edges of the component.
+ */
+int BridgeIndex::componentCut(int source, int target, std::vector<int>& side) {
+    side.clear();
+    if (source == target || component[source] != component[target])
+        return 0;
+
+    int flow = blockFlow(vertexSet[source], vertexSet[target], INF);
+    for (int v : members[component[source]])
+        if (vertexSet[v]->isVisited())
+            side.push_back(v);
+    return flow;
+}
+
+/**
+ * Finds a minimum cut between two stations using the bridge forest. The path between them crosses the same bridges
+ * and components as in maxFlow, and every cut must separate one of those steps, so the minimum cut is either the
+ * bridge with the smallest capacity or the minimum cut inside one crossed component (see componentCut), whichever is
+ * smaller. On ties, the step closest to the source is chosen.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return Edges of the minimum cut, from the side of the source to the side of the target (empty if no flow goes
+ * from the source to the target).
+ *
+ * @par Time complexity
+ * O(D + C * E²), where D is the depth of the bridge forest and C, E the vertexes and edges of the crossed components.
+ */
+std::vector<Edge *> BridgeIndex::minCut(int source, int target) {
+    std::vector<Edge *> cut;
+    int n = vertexSet.size();
+    if (source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return cut;
+
+    int cs = component[source], ct = component[target];
+    if (tree[cs] != tree[ct])
+        return cut;
+
+    Vertex* a = vertexSet[source];
+    Vertex* b = vertexSet[target];
+    std::vector<std::pair<Vertex*, Vertex*>> front, back;
+    std::vector<Edge*> frontBridges, backBridges;
+    while (cs != ct) {
+        if (depth[cs] >= depth[ct]) {
+            Edge* e = parentEdge[cs];
+            front.emplace_back(a, e->getDest());
+            frontBridges.push_back(e->getReverse());
+            a = e->getOrig();
+            cs = parent[cs];
+        }
+        else {
+            Edge* e = parentEdge[ct];
+            back.emplace_back(e->getDest(), b);
+            backBridges.push_back(e);
+            b = e->getOrig();
+            ct = parent[ct];
+        }
+    }
+
+    int best = INF;
+    std::vector<int> side;
+    auto crossing = [&](Vertex* from, Vertex* to) {
+        if (from == to) return;
+        int flow = componentCut(from->getId(), to->getId(), side);
+        if (flow >= best) return;
+        best = flow;
+        cut.clear();
+        for (int v : side)
+            for (Edge* e : adj[v])
+                if (component[e->getDest()->getId()] == component[v] && !e->getDest()->isVisited() && e->getCapacity() > 0)
+                    cut.push_back(e);
+    };
+    auto bridge = [&](Edge* e) {
+        if (e->getCapacity() >= best) return;
+        best = e->getCapacity();
+        cut = {e};
+    };
+
+    for (unsigned int i = 0; i < front.size(); i++) {
+        crossing(front[i].first, front[i].second);
+        bridge(frontBridges[i]);
+    }
+    crossing(a, b);
+    for (int i = (int) back.size() - 1; i >= 0; i--) {
+        bridge(backBridges[i]);
+        crossing(back[i].first, back[i].second);
+    }
+
+    if (best == 0) cut.clear();
+    return cut;
+}
@@ -0,0 +1,53 @@
+#ifndef DA_BRIDGEINDEX_H
+#define DA_BRIDGEINDEX_H
+
+#include <vector>
+#include <queue>
+#include <stack>
+#include <unordered_set>
+
+#include "Graph.h"
+
+class BridgeIndex {
+public:
+    BridgeIndex();
+    explicit BridgeIndex(const Graph& graph);
+
+    int maxFlow(int source, int target);
+    int componentCut(int source, int target, std::vector<int>& side);
+    std::vector<Edge *> minCut(int source, int target);
+
+    void addSegment(Edge* edge);
+    void removeSegment(Edge* edge);
+
+    bool isBridge(const Edge* edge) const;
+    int getComponent(int id) const;
+    int getTree(int id) const;
+    unsigned int getComponentCount() const;
+
+private:
+    std::vector<Vertex *> vertexSet;
+    std::vector<std::vector<Edge *>> adj;
+
+    std::unordered_set<const Edge *> bridges;
+
+    std::vector<int> component;
+    std::vector<std::vector<int>> members;
+
+    std::vector<int> parent;
+    std::vector<Edge *> parentEdge;
+    std::vector<int> depth;
+    std::vector<int> tree;
+    std::vector<Vertex *> searchQueue;
+    std::vector<std::pair<Vertex *, Vertex *>> pathSegments;
+
+    void reindex();
+    void findBridges();
+    void findComponents();
+    void buildBridgeTree();
+
+    bool findBlockAugmentingPath(Vertex* src, Vertex* dest);
+    int blockFlow(Vertex* src, Vertex* dest, int bound);
+};
+
+#endif //DA_BRIDGEINDEX_H
@@ -0,0 +1,47 @@
+#ifndef DA_CAPACITY_H
+#define DA_CAPACITY_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Arithmetic of the capacity type of a flow engine (int32_t for CsrGraph, int64_t for CsrGraph64) and of the costs
+ * of the flows (int, see Graph::flowCost). INFINITE is absorbing and any sum or product that overflows saturates to
+ * INFINITE, so an unbounded capacity or cost can never wrap around into a negative value.
+ */
+template <typename Capacity>
+struct CapacityTraits {
+    static constexpr Capacity INFINITE = std::numeric_limits<Capacity>::max();
+
+    static Capacity add(Capacity a, Capacity b) {
+        if (a == INFINITE || b == INFINITE) return INFINITE;
+#ifdef __GNUC__
+        Capacity sum;
+        if (__builtin_add_overflow(a, b, &sum)) return INFINITE;
+        return sum;
+#else
+        if (b > 0 && a > INFINITE - b) return INFINITE;
+        return a + b;
+#endif
+    }
+
+    static Capacity multiply(Capacity a, Capacity b) {
+        if (a == 0 || b == 0) return 0;
+        if (a == INFINITE || b == INFINITE) return INFINITE;
+#ifdef __GNUC__
+        Capacity product;
+        if (__builtin_mul_overflow(a, b, &product)) return INFINITE;
+        return product;
+#else
+        if (a > INFINITE / b) return INFINITE;
+        return a * b;
+#endif
+    }
+
+    static Capacity subtract(Capacity a, Capacity b) {
+        if (a == INFINITE) return INFINITE;
+        return a - b;
+    }
+};
+
+#endif //DA_CAPACITY_H
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstdint>
+
+#include "Supervisor.h"
+#include "CsrGraph.h"
+
+#define LARGE 2000000000
+
+static bool ok = true;
+
+/**
+ * Prints the result of a check and records whether it failed.\n\n
+ *
+ * @param name Name of the check.
+ * @param passed True if the check passed.
+ */
+static void check(const char* name, bool passed) {
+    std::printf("%-52s %s\n", name, passed ? "ok" : "FAILED");
+    ok &= passed;
+}
+
+/**
+ * Checks the capacity types of the flow engines: the 64-bit CSR graph (CsrGraph64) must give the same flows as the
+ * 32-bit one (CsrGraph) on the network, keep flows that do not fit in 32 bits, which CsrGraph saturates, and the
+ * costs of the flows must saturate instead of overflowing. Must be run from a directory next to data, like the
+ * program.\n\n
+ *
+ * @return 0 if every check passes, 1 otherwise.
+ */
+int main() {
+    Supervisor supervisor;
+    Graph graph = supervisor.originalGraph();
+    CsrGraph csr(graph);
+    CsrGraph64 csr64(graph);
+    int n = (int) graph.getVertexSet().size();
+
+    bool same = true;
+    for (int i = 0; i < n; i++) {
+        int j = (i * 7 + 3) % n;
+        same &= (int64_t) csr.maxFlow(i, j) == csr64.maxFlow(i, j);
+        same &= (int64_t) csr.superSourceFlow(i) == csr64.superSourceFlow(i);
+    }
+    check("CsrGraph64 flows match CsrGraph on the network", same);
+
+    Graph large;
+    for (int id = 0; id < 4; id++)
+        large.addVertex(id, Station(""));
+    large.addEdge(0, 1, LARGE, Service::STANDARD);
+    large.addEdge(1, 3, LARGE, Service::STANDARD);
+    large.addEdge(0, 2, LARGE, Service::STANDARD);
+    large.addEdge(2, 3, LARGE, Service::STANDARD);
+    CsrGraph largeCsr(large);
+    CsrGraph64 largeCsr64(large);
+    check("CsrGraph64 keeps a flow larger than 32 bits", largeCsr64.maxFlow(0, 3) == 2 * (int64_t) LARGE);
+    check("CsrGraph saturates a flow larger than 32 bits", largeCsr.maxFlow(0, 3) == CapacityTraits<int32_t>::INFINITE);
+    check("Graph::minCost saturates a cost larger than 32 bits", large.minCost(0, 3) == INF);
+
+    check("CapacityTraits::multiply saturates", CapacityTraits<int>::multiply(LARGE, 2) == INF);
+    check("CapacityTraits::multiply keeps 0 * INFINITE at 0", CapacityTraits<int>::multiply(0, INF) == 0);
+    check("CapacityTraits::add saturates", CapacityTraits<int>::add(LARGE, LARGE) == INF);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,336 @@
+#include "ChainContraction.h"
+
+ChainContraction::ChainContraction() = default;
+
+/**
+ * Finds every chain of the graph, that is, every unbranched line segment whose inner stations have exactly two
+ * neighbours, and builds the reduced graph where each chain is a single segment. The stations that are not inside a
+ * chain (junctions, terminal stations and one station of each isolated ring) are the terminals of the reduced graph,
+ * which also has two spare vertexes where the source and target stations of a query are placed.\n\n
+ *
+ * @param graph The graph to contract.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+ChainContraction::ChainContraction(const Graph& graph) {
+    vertexSet = graph.getVertexSet();
+    for (Vertex* v : vertexSet)
+        adj.push_back(v->getAdj());
+
+    findChains();
+
+    terminalId.assign(vertexSet.size(), -1);
+    for (int v = 0; v < (int) vertexSet.size(); v++)
+        if (terminal[v]) {
+            terminalId[v] = terminals.size();
+            reduced.addVertex(terminalId[v], vertexSet[v]->getStation());
+            terminals.push_back(v);
+        }
+    reduced.addVertex((int) terminals.size(), Station(""));
+    reduced.addVertex((int) terminals.size() + 1, Station(""));
+
+    for (Chain& chain : chains)
+        chain.segment = addSegment(chain, 0, (int) chain.stations.size() + 1);
+}
+
+/**
+ * @return The number of stations kept by the contraction.
+ */
+unsigned int ChainContraction::getTerminalCount() const {
+    return terminals.size();
+}
+
+/**
+ * @return The number of chains, each one contracted into a single segment.
+ */
+unsigned int ChainContraction::getChainCount() const {
+    return chains.size();
+}
+
+/**
+ * Marks the terminals and walks every chain that starts at one of them. Vertexes left unvisited belong to rings
+ * without any junction, so one of their stations becomes a terminal and the ring is walked from it.\n\n
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+void ChainContraction::findChains() {
+    int n = vertexSet.size();
+    terminal.assign(n, false);
+    chainOf.assign(n, -1);
+    position.assign(n, 0);
+
+    for (int v = 0; v < n; v++)
+        terminal[v] = adj[v].size() != 2 || adj[v][0]->getDest() == adj[v][1]->getDest();
+
+    std::unordered_set<const Edge*> used;
+    for (int v = 0; v < n; v++)
+        if (terminal[v])
+            for (Edge* e : adj[v])
+                if (used.find(e) == used.end())
+                    walkChain(v, e, used);
+
+    for (int v = 0; v < n; v++)
+        if (!terminal[v] && chainOf[v] == -1) {
+            terminal[v] = true;
+            for (Edge* e : adj[v])
+                if (used.find(e) == used.end())
+                    walkChain(v, e, used);
+        }
+}
+
+/**
+ * Follows a chain from a terminal until the next terminal, storing its inner stations and its edges in order.\n\n
+ *
+ * @param from The terminal where the chain starts.
+ * @param edge The first edge of the chain.
+ * @param used The edges already walked (both directions of each segment).
+ *
+ * @par Time complexity
+ * O(k), where k is the number of segments of the chain.
+ */
+void ChainContraction::walkChain(int from, Edge* edge, std::unordered_set<const Edge*>& used) {
+    Chain chain;
+    chain.from = from;
+    int index = chains.size();
+
+    while (true) {
+        used.insert(edge);
+        used.insert(edge->getReverse());
+        chain.edges.push_back(edge);
+
+        int w = edge->getDest()->getId();
+        if (terminal[w]) {
+            chain.to = w;
+            break;
+        }
+        chain.stations.push_back(w);
+        chainOf[w] = index;
+        position[w] = chain.stations.size();
+
+        edge = adj[w][0] == edge->getReverse() ? adj[w][1] : adj[w][0];
+    }
+    chains.push_back(chain);
+}
+
+/**
+ * @param chain The chain.
+ * @param i Position along the chain, from 0 (first terminal) to the number of inner stations + 1 (last terminal).
+ * @return The identifier of the vertex at that position.
+ */
+int ChainContraction::chainVertex(const Chain& chain, int i) const {
+    if (i == 0) return chain.from;
+    if (i == (int) chain.stations.size() + 1) return chain.to;
+    return chain.stations[i - 1];
+}
+
+/**
+ * @param id The identifier of a vertex of the original graph.
+ * @return The identifier of that vertex in the reduced graph, or -1 if it was contracted.
+ */
+int ChainContraction::getReducedId(int id) const {
+    if (id < 0 || id >= (int) vertexSet.size()) return -1;
+    if (terminal[id]) return terminalId[id];
+    for (int i = 0; i < (int) pinned.size(); i++)
+        if (pinned[i] == id) return (int) terminals.size() + i;
+    return -1;
+}
+
+/**
+ * Adds to the reduced graph the segment that replaces the part of a chain between two positions. Its capacity is
+ * the smallest capacity along that part and its cost is the sum of the costs.\n\n
+ *
+ * @param chain The chain.
+ * @param first Position where the segment starts.
+ * @param last Position where the segment ends.
+ *
+ * @return The new edge (from the first to the last position), or nullptr if both ends are the same vertex.
+ *
+ * @par Time complexity
+ * O(k), where k is the number of segments of the chain.
+ */
+Edge* ChainContraction::addSegment(const Chain& chain, int first, int last) {
+    int a = getReducedId(chainVertex(chain, first));
+    int b = getReducedId(chainVertex(chain, last));
+    if (a == b) return nullptr;
+
+    int capacity = INF, cost = 0;
+    std::vector<int> stations;
+    for (int i = first; i < last; i++) {
+        capacity = std::min(capacity, chain.edges[i]->getCapacity());
+        cost = CapacityTraits<int>::add(cost, chain.edges[i]->getCost());
+        stations.push_back(chainVertex(chain, i));
+    }
+    stations.push_back(chainVertex(chain, last));
+
+    Vertex* va = reduced.findVertex(a);
+    Vertex* vb = reduced.findVertex(b);
+    Edge* e1 = va->addEdge(vb, capacity, Service::NONE);
+    Edge* e2 = vb->addEdge(va, capacity, Service::NONE);
+    e1->setCost(cost);
+    e2->setCost(cost);
+    e1->setReverse(e2);
+    e2->setReverse(e1);
+
+    segments[e1] = std::make_pair((int) segmentStations.size(), true);
+    segments[e2] = std::make_pair((int) segmentStations.size(), false);
+    segmentStations.push_back(stations);
+    return e1;
+}
+
+/**
+ * Undoes the changes made to the reduced graph by the last query: removes the segments of the source and target
+ * stations and gives back the capacity of the chains they split.\n\n
+ *
+ * @par Time complexity
+ * O(k), where k is the number of segments removed.
+ */
+void ChainContraction::restore() {
+    segmentStations.resize(segmentStations.size() - pinnedSegments.size());
+    for (auto it = pinnedSegments.rbegin(); it != pinnedSegments.rend(); it++) {
+        Edge* e = *it;
+        segments.erase(e);
+        segments.erase(e->getReverse());
+        e->getDest()->removeEdge(e->getReverse());
+        e->getOrig()->removeEdge(e);
+    }
+
+    for (int c : splitChains) {
+        Edge* e = chains[c].segment;
+        if (e == nullptr) continue;
+        int capacity = INF;
+        for (Edge* edge : chains[c].edges)
+            capacity = std::min(capacity, edge->getCapacity());
+        e->setCapacity(capacity);
+        e->getReverse()->setCapacity(capacity);
+    }
+
+    pinned.clear();
+    splitChains.clear();
+    pinnedSegments.clear();
+}
+
+/**
+ * Prepares the reduced graph for a query between two stations. Stations inside a chain are placed on the spare
+ * vertexes, the segment of their chain is closed and replaced by the parts of the chain between them and the
+ * terminals. The graph stays like this until the next call.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The reduced graph.
+ *
+ * @par Time complexity
+ * O(k), where k is the number of segments of the chains of the source and target.
+ */
+const Graph& ChainContraction::reduce(int source, int target) {
+    restore();
+
+    for (int v : {source, target})
+        if (v >= 0 && v < (int) vertexSet.size() && !terminal[v] && getReducedId(v) == -1) {
+            reduced.findVertex((int) terminals.size() + pinned.size())->setStation(vertexSet[v]->getStation());
+            pinned.push_back(v);
+            if (std::find(splitChains.begin(), splitChains.end(), chainOf[v]) == splitChains.end())
+                splitChains.push_back(chainOf[v]);
+        }
+
+    for (int c : splitChains) {
+        const Chain& chain = chains[c];
+        if (chain.segment != nullptr) {
+            chain.segment->setCapacity(0);
+            chain.segment->getReverse()->setCapacity(0);
+        }
+
+        std::vector<int> cuts = {0, (int) chain.stations.size() + 1};
+        for (int v : pinned)
+            if (chainOf[v] == c)
+                cuts.push_back(position[v]);
+        std::sort(cuts.begin(), cuts.end());
+
+        for (unsigned int i = 0; i + 1 < cuts.size(); i++) {
+            Edge* e = addSegment(chain, cuts[i], cuts[i + 1]);
+            if (e != nullptr) pinnedSegments.push_back(e);
+        }
+    }
+    return reduced;
+}
+
+/**
+ * Expands a segment of the last reduced graph back into the stations of the original graph.\n\n
+ *
+ * @param edge An edge of the reduced graph.
+ *
+ * @return The identifiers of the original stations crossed by the edge, from its origin to its destination.
+ *
+ * @par Time complexity
+ * O(k), where k is the number of stations of the contracted chain.
+ */
+std::vector<int> ChainContraction::expand(const Edge* edge) const {
+    auto it = segments.find(edge);
+    if (it == segments.end()) return {};
+    std::vector<int> stations = segmentStations[it->second.first];
+    if (!it->second.second)
+        std::reverse(stations.begin(), stations.end());
+    return stations;
+}
+
+/**
+ * Calculates the max flow between two stations on the reduced graph.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The maximum flow from the source vertex to the target vertex.
+ *
+ * @par Time complexity
+ * O(T * S²), where T is the number of terminals and S the number of segments in the reduced graph.
+ */
+int ChainContraction::maxFlow(int source, int target) {
+    if (source == target) return 0;
+    reduce(source, target);
+    int src = getReducedId(source), dest = getReducedId(target);
+    if (src == -1 || dest == -1) return 0;
+    return reduced.maxFlow(src, dest, true);
+}
+
+/**
+ * Calculates the minimum cost of the max flow between two stations on the reduced graph.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The minimum cost of the flow from the source to the target, or 0 if there is no feasible flow.
+ *
+ * @par Time complexity
+ * O(T * S² * log(T)), where T is the number of terminals and S the number of segments in the reduced graph.
+ */
+int ChainContraction::minCost(int source, int target) {
+    if (source == target) return 0;
+    reduce(source, target);
+    int src = getReducedId(source), dest = getReducedId(target);
+    if (src == -1 || dest == -1) return 0;
+    return reduced.minCost(src, dest);
+}
+
+/**
+ * Calculates the routes followed by the trains between two stations when the maximum number of trains travels at the
+ * minimum cost. The flow is found on the reduced graph, like minCost, and every segment of a route is expanded back
+ * into the stations of its chain, so the cost of the routes is the cost given by minCost.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The routes: original station ids from the source to the target, number of trains and cost of one train.
+ *
+ * @par Time complexity
+ * O(T * S² * log(T) + S * P * k), where T is the number of terminals and S the number of segments in the reduced
+ * graph, P the number of routes and k the number of stations of the longest chain.
+ */
+std::vector<Route> ChainContraction::routes(int source, int target) {
+    if (source == target) return {};
+    minCost(source, target);
+    int src = getReducedId(source), dest = getReducedId(target);
+    if (src == -1 || dest == -1) return {};
+    return reduced.flowRoutes(src, dest, [this](const Edge* edge) { return expand(edge); });
+}
@@ -0,0 +1,60 @@
+#ifndef DA_CHAINCONTRACTION_H
+#define DA_CHAINCONTRACTION_H
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Graph.h"
+
+class ChainContraction {
+public:
+    ChainContraction();
+    explicit ChainContraction(const Graph& graph);
+
+    int maxFlow(int source, int target);
+    int minCost(int source, int target);
+    std::vector<Route> routes(int source, int target);
+
+    const Graph& reduce(int source, int target);
+    int getReducedId(int id) const;
+    std::vector<int> expand(const Edge* edge) const;
+
+    unsigned int getTerminalCount() const;
+    unsigned int getChainCount() const;
+
+private:
+    struct Chain {
+        int from, to;
+        std::vector<int> stations;
+        std::vector<Edge *> edges;
+        Edge *segment = nullptr;
+    };
+
+    std::vector<Vertex *> vertexSet;
+    std::vector<std::vector<Edge *>> adj;
+
+    std::vector<bool> terminal;
+    std::vector<int> terminals;
+    std::vector<int> terminalId;
+    std::vector<int> chainOf;
+    std::vector<int> position;
+    std::vector<Chain> chains;
+
+    Graph reduced;
+    std::unordered_map<const Edge *, std::pair<int, bool>> segments;
+    std::vector<std::vector<int>> segmentStations;
+
+    std::vector<int> pinned;
+    std::vector<int> splitChains;
+    std::vector<Edge *> pinnedSegments;
+
+    void findChains();
+    void walkChain(int from, Edge* edge, std::unordered_set<const Edge *>& used);
+
+    int chainVertex(const Chain& chain, int i) const;
+    Edge* addSegment(const Chain& chain, int first, int last);
+    void restore();
+};
+
+#endif //DA_CHAINCONTRACTION_H
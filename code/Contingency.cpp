@@ -0,0 +1,500 @@
+#include "Contingency.h"
+
+#include <cstdlib>
+
+/**
+ * Prepares the N-1 contingency analysis of a network: computes the flow of every station on the intact network and
+ * records, for each segment and station, which station flows go through it (and, for segments, how much of each).
+ * Only those flows can decrease when it fails, since a failure never adds capacity. The sources are always the line
+ * ends of the intact network (the stations with a single segment before any failure, see Supervisor::lineEnds): a
+ * station left with a single segment by a failure does not become a source, the same definition as
+ * Supervisor::flowDifference.\n\n
+ *
+ * @param csr The CSR copy of the intact network.
+ *
+ * @par Time complexity
+ * O(V² * E²), where V is the number of vertexes and E the number of edges in the graph.
+ */
+Contingency::Contingency(const CsrGraph& csr): base(csr) {
+    stations = base.getSuperSource();
+    segments = base.getSegments();
+
+    int arcs = base.getArcs(stations).second;
+    segmentOf.assign(arcs, -1);
+    for (int s = 0; s < (int) segments.size(); s++) {
+        segmentOf[segments[s]] = s;
+        segmentOf[base.getReverse(segments[s])] = s;
+    }
+
+    flows.assign(stations, 0);
+    segmentUsers.assign(segments.size(), {});
+    segmentFlow.assign(stations, std::vector<int>(segments.size(), 0));
+    stationUsers.assign(stations, {});
+
+    for (int t = 0; t < stations; t++) {
+        flows[t] = base.superSourceFlow(t);
+        totalFlow += flows[t];
+        stationUsers[t].push_back(t);
+        if (flows[t] == 0) continue;
+
+        for (int s = 0; s < (int) segments.size(); s++)
+            if (base.getFlow(segments[s]) != 0) {
+                segmentUsers[s].push_back(t);
+                segmentFlow[t][s] = std::abs(base.getFlow(segments[s]));
+            }
+
+        for (int v = 0; v < stations; v++) {
+            if (v == t) continue;
+            auto arcsOfV = base.getArcs(v);
+            for (int a = arcsOfV.first; a < arcsOfV.second; a++)
+                if (base.getFlow(a) != 0) {
+                    stationUsers[v].push_back(t);
+                    break;
+                }
+        }
+    }
+}
+
+/**
+ * @return Sum of the flows of every station on the intact network.
+ */
+int Contingency::getTotalFlow() const {
+    return totalFlow;
+}
+
+/**
+ * @param id The identifier of the station.
+ * @return The flow of the station on the intact network.
+ */
+int Contingency::getStationFlow(int id) const {
+    return flows[id];
+}
+
+/**
+ * Calculates how much of the total flow is lost when a segment fails, by closing both of its edges on the overlay and
+ * recomputing only the station flows that went through it.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread.
+ * @param segment The index of the segment.
+ *
+ * @return The flow lost.
+ *
+ * @par Time complexity
+ * O(k * V * E²), where k is the number of station flows that used the segment.
+ */
+int Contingency::segmentLoss(CsrGraph& csr, int segment) const {
+    int a = segments[segment], r = csr.getReverse(a);
+    int capacity = csr.getCapacity(a);
+    csr.setCapacity(a, 0);
+    csr.setCapacity(r, 0);
+
+    int loss = 0;
+    for (int t : segmentUsers[segment])
+        loss += flows[t] - csr.superSourceFlow(t);
+
+    csr.setCapacity(a, capacity);
+    csr.setCapacity(r, capacity);
+    return loss;
+}
+
+/**
+ * Calculates how much of the total flow is lost when a station fails, by closing every edge of the station on the
+ * overlay. The flow of the station itself is lost and only the station flows that went through it are recomputed.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread.
+ * @param station The identifier of the station.
+ *
+ * @return The flow lost.
+ *
+ * @par Time complexity
+ * O(k * V * E²), where k is the number of station flows that used the station.
+ */
+int Contingency::stationLoss(CsrGraph& csr, int station) const {
+    auto arcs = csr.getArcs(station);
+    std::vector<int> capacities;
+    for (int a = arcs.first; a < arcs.second; a++) {
+        capacities.push_back(csr.getCapacity(a));
+        csr.setCapacity(a, 0);
+        csr.setCapacity(csr.getReverse(a), 0);
+    }
+
+    int loss = 0;
+    for (int t : stationUsers[station])
+        loss += t == station ? flows[t] : flows[t] - csr.superSourceFlow(t);
+
+    for (int a = arcs.first; a < arcs.second; a++) {
+        csr.setCapacity(a, capacities[a - arcs.first]);
+        csr.setCapacity(csr.getReverse(a), capacities[a - arcs.first]);
+    }
+    return loss;
+}
+
+/**
+ * @param threads Number of threads wanted (0 for the number of cores).
+ * @param jobs Number of failures to evaluate.
+ * @return The number of threads to use.
+ */
+unsigned int Contingency::workerCount(unsigned int threads, unsigned int jobs) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::max(1u, std::min(threads, jobs));
+}
+
+/**
+ * Evaluates the failure of every segment, in parallel. Each thread works on its own copy of the network and on an
+ * interleaved share of the segments.\n\n
+ *
+ * @param threads Number of threads (0 for the number of cores).
+ *
+ * @return Vector of pairs segment edge index (see CsrGraph::getSegments) and flow lost, one per segment.
+ *
+ * @par Time complexity
+ * O(S * k * V * E² / p), where S is the number of segments, k the station flows that use each one and p the threads.
+ */
+std::vector<std::pair<int, int>> Contingency::segmentLosses(unsigned int threads) const {
+    std::vector<std::pair<int, int>> res(segments.size());
+    unsigned int workers = workerCount(threads, segments.size());
+
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < workers; w++)
+        pool.emplace_back([this, &res, w, workers]() {
+            CsrGraph csr = base;
+            for (unsigned int s = w; s < segments.size(); s += workers)
+                res[s] = std::make_pair(segments[s], segmentLoss(csr, s));
+        });
+    for (auto& worker : pool)
+        worker.join();
+
+    return res;
+}
+
+/**
+ * Evaluates the failure of every station, in parallel. Each thread works on its own copy of the network and on an
+ * interleaved share of the stations.\n\n
+ *
+ * @param threads Number of threads (0 for the number of cores).
+ *
+ * @return Vector of pairs station id and flow lost, one per station.
+ *
+ * @par Time complexity
+ * O(V * k * V * E² / p), where k is the number of station flows that use each station and p the threads.
+ */
+std::vector<std::pair<int, int>> Contingency::stationLosses(unsigned int threads) const {
+    std::vector<std::pair<int, int>> res(stations);
+    unsigned int workers = workerCount(threads, stations);
+
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < workers; w++)
+        pool.emplace_back([this, &res, w, workers]() {
+            CsrGraph csr = base;
+            for (int v = (int) w; v < stations; v += (int) workers)
+                res[v] = std::make_pair(v, stationLoss(csr, v));
+        });
+    for (auto& worker : pool)
+        worker.join();
+
+    return res;
+}
+
+
+/**
+ * Closes or reopens both edges of a segment on the overlay.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread.
+ * @param segment The index of the segment.
+ * @param open True to give the segment back its capacity, false to close it.
+ */
+void Contingency::setSegment(CsrGraph& csr, int segment, bool open) const {
+    int a = segments[segment];
+    int capacity = open ? base.getCapacity(a) : 0;
+    csr.setCapacity(a, capacity);
+    csr.setCapacity(csr.getReverse(a), capacity);
+}
+
+/**
+ * Recomputes the flow of a station with the segments of the current tuple closed, storing how much it lost and how
+ * much flow it sends through each segment.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread, with the segments of the tuple closed.
+ * @param level The state of the tuple.
+ * @param station The identifier of the station.
+ *
+ * @par Time complexity
+ * O(V * E²).
+ */
+void Contingency::recompute(CsrGraph& csr, TupleLevel& level, int station) const {
+    int lost = flows[station] - csr.superSourceFlow(station);
+
+    if (level.stored == level.storage.size())
+        level.storage.emplace_back(segments.size());
+    std::vector<int>& through = level.storage[level.stored++];
+    for (unsigned int s = 0; s < segments.size(); s++)
+        through[s] = std::abs(csr.getFlow(segments[s]));
+
+    level.position[station] = (int) level.affected.size();
+    level.affected.push_back(station);
+    level.lost.push_back(lost);
+    level.through.push_back(through.data());
+    level.loss += lost;
+}
+
+/**
+ * Builds the state of a tuple from the state of the tuple without its last segment. A station whose flow did not go
+ * through the new segment keeps it, since it is still a maximum flow with one more segment closed; every other
+ * station is recomputed.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread, with all the segments of the tuple closed.
+ * @param parent The state of the tuple without its last segment.
+ * @param level The state to build.
+ * @param segment The last segment of the tuple.
+ *
+ * @par Time complexity
+ * O(r * V * E²), where r is the number of station flows that went through the new segment.
+ */
+void Contingency::extend(CsrGraph& csr, const TupleLevel& parent, TupleLevel& level, int segment) const {
+    for (int t : level.affected)
+        level.position[t] = -1;
+    level.affected.clear();
+    level.lost.clear();
+    level.through.clear();
+    level.stored = 0;
+    level.loss = 0;
+
+    for (unsigned int i = 0; i < parent.affected.size(); i++) {
+        int t = parent.affected[i];
+        if (parent.through[i][segment] != 0) {
+            recompute(csr, level, t);
+            continue;
+        }
+        level.position[t] = (int) level.affected.size();
+        level.affected.push_back(t);
+        level.lost.push_back(parent.lost[i]);
+        level.through.push_back(parent.through[i]);
+        level.loss += parent.lost[i];
+    }
+    for (int t : segmentUsers[segment])
+        if (parent.position[t] == -1)
+            recompute(csr, level, t);
+}
+
+/**
+ * Upper bound of the flow that each of the segments in positions [start, end) of the search order adds to the loss of
+ * a tuple. A station sending f units through a segment loses at most f more when it closes, since its flow minus the
+ * paths that used the segment is still valid, and never more than what it has left.\n\n
+ *
+ * @param search The state shared by all the threads.
+ * @param level The state of the tuple.
+ * @param start First position of the search order.
+ *
+ * @par Time complexity
+ * O(a * S), where a is the number of stations whose flow changed and S the number of segments.
+ */
+void Contingency::extraBounds(const TupleSearch& search, TupleLevel& level, unsigned int start) const {
+    level.extra.assign(search.order.size(), 0);
+    for (unsigned int j = start; j < search.order.size(); j++)
+        level.extra[j] = search.bound[search.order[j]];
+
+    for (unsigned int i = 0; i < level.affected.size(); i++) {
+        int t = level.affected[i], left = flows[t] - level.lost[i];
+        for (unsigned int j = start; j < search.order.size(); j++) {
+            int s = search.order[j];
+            level.extra[j] += std::min(left, level.through[i][s]) - std::min(flows[t], segmentFlow[t][s]);
+        }
+    }
+}
+
+/**
+ * Calculates the loss of a tuple given the state of the tuple without its last segment. Only the stations whose flow
+ * went through the last segment are recomputed, the ones that can lose more first, and the evaluation is abandoned
+ * once the loss can no longer exceed the threshold.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread, with all the segments of the tuple closed.
+ * @param parent The state of the tuple without its last segment.
+ * @param segment The last segment of the tuple.
+ * @param threshold Loss the tuple has to exceed.
+ *
+ * @return The flow lost, or -1 if it does not exceed the threshold.
+ *
+ * @par Time complexity
+ * O(r * V * E²), where r is the number of station flows that went through the last segment.
+ */
+int Contingency::tupleLoss(CsrGraph& csr, const TupleLevel& parent, int segment, int threshold) const {
+    std::vector<std::pair<int, int>> bounds;
+    int remaining = 0;
+    for (unsigned int i = 0; i < parent.affected.size(); i++) {
+        int bound = std::min(flows[parent.affected[i]] - parent.lost[i], parent.through[i][segment]);
+        if (bound > 0)
+            bounds.emplace_back(bound, parent.affected[i]);
+    }
+    for (int t : segmentUsers[segment])
+        if (parent.position[t] == -1)
+            bounds.emplace_back(std::min(flows[t], segmentFlow[t][segment]), t);
+    for (auto& bound : bounds)
+        remaining += bound.first;
+    std::sort(bounds.rbegin(), bounds.rend());
+
+    int loss = parent.loss;
+    for (auto& bound : bounds) {
+        if (loss + remaining <= threshold)
+            return -1;
+        int t = bound.second, lost = parent.position[t] == -1 ? 0 : parent.lost[parent.position[t]];
+        loss += flows[t] - csr.superSourceFlow(t) - lost;
+        remaining -= bound.first;
+    }
+    return loss > threshold ? loss : -1;
+}
+
+/**
+ * Keeps a tuple among the worst ones found, updating the threshold when the top is full, and reports it.\n\n
+ *
+ * @param search The state shared by all the threads.
+ * @param tuple The indexes of the segments.
+ * @param loss The flow lost.
+ *
+ * @par Time complexity
+ * O(k + log(c)), where k is the size of the tuple and c the number of tuples wanted.
+ */
+void Contingency::keepTuple(TupleSearch& search, const std::vector<int>& tuple, int loss) const {
+    std::lock_guard<std::mutex> guard(search.lock);
+    if (loss <= search.threshold.load()) return;
+
+    auto worse = [](const std::pair<std::vector<int>, int>& a, const std::pair<std::vector<int>, int>& b) {
+        return a.second > b.second;
+    };
+    search.best.emplace_back(tuple, loss);
+    std::push_heap(search.best.begin(), search.best.end(), worse);
+    if (search.best.size() > search.count) {
+        std::pop_heap(search.best.begin(), search.best.end(), worse);
+        search.best.pop_back();
+    }
+    if (search.best.size() == search.count)
+        search.threshold = search.best.front().second;
+
+    if (search.onResult) {
+        std::vector<int> arcs;
+        for (int s : tuple)
+            arcs.push_back(segments[s]);
+        search.onResult(arcs, loss);
+    }
+}
+
+/**
+ * Enumerates the tuples that extend the current one with a segment in positions [start, end) of the search order
+ * (and then with later segments only). A branch is skipped when the loss of the current tuple plus the bounds of the
+ * segments that could still be added cannot beat the worst of the tuples kept.\n\n
+ *
+ * @param csr The CSR copy used by the calling thread, with the segments of the current tuple closed.
+ * @param search The state shared by all the threads.
+ * @param levels The states of the current tuple and of its prefixes, one per size.
+ * @param tuple The segments chosen so far.
+ * @param start First position of the search order that can be chosen next.
+ * @param end Position after the last one that can be chosen next.
+ *
+ * @par Time complexity
+ * O(C(S, k)) tuples in the worst case, where S is the number of segments.
+ */
+void Contingency::searchTuples(CsrGraph& csr, TupleSearch& search, std::vector<TupleLevel>& levels, std::vector<int>& tuple,
+                               unsigned int start, unsigned int end) const {
+    unsigned int depth = tuple.size(), missing = search.k - depth, size = search.order.size();
+    TupleLevel& level = levels[depth];
+    extraBounds(search, level, start);
+
+    std::vector<int> best(size + 1, 0), top;
+    for (unsigned int j = size; j-- > start;) {
+        best[j] = 0;
+        for (int value : top)
+            best[j] += value;
+        top.push_back(level.extra[j]);
+        std::sort(top.rbegin(), top.rend());
+        if (top.size() > missing - 1)
+            top.pop_back();
+    }
+
+    for (unsigned int j = start; j < end && j + missing <= size; j++) {
+        if (level.loss + level.extra[j] + best[j] <= search.threshold.load())
+            continue;
+
+        int segment = search.order[j];
+        tuple.push_back(segment);
+        setSegment(csr, segment, false);
+
+        if (missing == 1) {
+            int loss = tupleLoss(csr, level, segment, search.threshold.load());
+            if (loss != -1)
+                keepTuple(search, tuple, loss);
+        }
+        else {
+            extend(csr, level, levels[depth + 1], segment);
+            searchTuples(csr, search, levels, tuple, j + 1, size);
+        }
+
+        setSegment(csr, segment, true);
+        tuple.pop_back();
+    }
+}
+
+/**
+ * Finds the tuples of k segments whose simultaneous failure causes the largest loss of flow (N-k contingency
+ * analysis). The tuples are enumerated in order of the bound of their segments, with the first segment split among
+ * the threads. Each tuple keeps the flows of the stations it affects, so adding a segment only recomputes the
+ * stations whose flow went through it, and branches that cannot beat the worst tuple kept are pruned. Each tuple
+ * that enters the current top is passed to onResult as soon as it is found.\n\n
+ *
+ * @param k Number of segments that fail at the same time.
+ * @param count Number of tuples wanted.
+ * @param threads Number of threads (0 for the number of cores).
+ * @param onResult Function called with each tuple (segment edge indexes) that enters the top, and its loss.
+ *
+ * @return Vector of pairs tuple of segment edge indexes and flow lost, ordered by descending loss.
+ *
+ * @par Time complexity
+ * O(C(S, k) * k * u * V * E² / p) in the worst case, where S is the number of segments, u the station flows that
+ * use each segment and p the threads.
+ */
+std::vector<std::pair<std::vector<int>, int>> Contingency::worstSegmentTuples(unsigned int k, unsigned int count, unsigned int threads,
+        const std::function<void(const std::vector<int>&, int)>& onResult) const {
+    TupleSearch search;
+    search.k = k;
+    search.count = count;
+    search.threshold = count == 0 ? INF : -1;
+    search.onResult = onResult;
+
+    for (unsigned int s = 0; s < segments.size(); s++) {
+        int bound = 0;
+        for (int t : segmentUsers[s])
+            bound += std::min(flows[t], segmentFlow[t][s]);
+        search.bound.push_back(bound);
+        search.order.push_back(s);
+    }
+    std::sort(search.order.begin(), search.order.end(), [&search](int a, int b) {
+        return search.bound[a] > search.bound[b];
+    });
+
+    if (k > 0 && k <= segments.size()) {
+        unsigned int workers = workerCount(threads, segments.size() - k + 1);
+        std::vector<std::thread> pool;
+        for (unsigned int w = 0; w < workers; w++)
+            pool.emplace_back([this, &search, w, workers]() {
+                CsrGraph csr = base;
+                std::vector<TupleLevel> levels(search.k);
+                for (auto& level : levels)
+                    level.position.assign(stations, -1);
+                std::vector<int> tuple;
+                for (unsigned int i = w; i + search.k <= search.order.size(); i += workers)
+                    searchTuples(csr, search, levels, tuple, i, i + 1);
+            });
+        for (auto& worker : pool)
+            worker.join();
+    }
+
+    std::vector<std::pair<std::vector<int>, int>> res;
+    for (auto& entry : search.best) {
+        std::vector<int> arcs;
+        for (int s : entry.first)
+            arcs.push_back(segments[s]);
+        res.emplace_back(arcs, entry.second);
+    }
+    std::sort(res.begin(), res.end(), [](const std::pair<std::vector<int>, int>& a, const std::pair<std::vector<int>, int>& b) {
+        return a.second > b.second;
+    });
+    return res;
+}
@@ -0,0 +1,73 @@
+#ifndef DA_CONTINGENCY_H
+#define DA_CONTINGENCY_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+#include "CsrGraph.h"
+
+class Contingency {
+public:
+    explicit Contingency(const CsrGraph& csr);
+
+    int getTotalFlow() const;
+    int getStationFlow(int id) const;
+
+    std::vector<std::pair<int, int>> segmentLosses(unsigned int threads) const;
+    std::vector<std::pair<int, int>> stationLosses(unsigned int threads) const;
+
+    std::vector<std::pair<std::vector<int>, int>> worstSegmentTuples(unsigned int k, unsigned int count, unsigned int threads,
+        const std::function<void(const std::vector<int>&, int)>& onResult = nullptr) const;
+
+private:
+    CsrGraph base;
+    int stations;
+    int totalFlow = 0;
+
+    std::vector<int> segments;
+    std::vector<int> segmentOf;
+    std::vector<int> flows;
+    std::vector<std::vector<int>> segmentUsers;
+    std::vector<std::vector<int>> segmentFlow;
+    std::vector<std::vector<int>> stationUsers;
+
+    struct TupleSearch {
+        unsigned int k, count;
+        std::vector<int> order;
+        std::vector<int> bound;
+        std::vector<std::pair<std::vector<int>, int>> best;
+        std::atomic<int> threshold;
+        std::mutex lock;
+        std::function<void(const std::vector<int>&, int)> onResult;
+    };
+
+    struct TupleLevel {
+        std::vector<int> affected;
+        std::vector<int> lost;
+        std::vector<const int*> through;
+        std::vector<int> position;
+        std::vector<std::vector<int>> storage;
+        unsigned int stored = 0;
+        int loss = 0;
+        std::vector<int> extra;
+    };
+
+    int segmentLoss(CsrGraph& csr, int segment) const;
+    int stationLoss(CsrGraph& csr, int station) const;
+
+    void setSegment(CsrGraph& csr, int segment, bool open) const;
+    void recompute(CsrGraph& csr, TupleLevel& level, int station) const;
+    void extend(CsrGraph& csr, const TupleLevel& parent, TupleLevel& level, int segment) const;
+    void extraBounds(const TupleSearch& search, TupleLevel& level, unsigned int start) const;
+    int tupleLoss(CsrGraph& csr, const TupleLevel& parent, int segment, int threshold) const;
+    void keepTuple(TupleSearch& search, const std::vector<int>& tuple, int loss) const;
+    void searchTuples(CsrGraph& csr, TupleSearch& search, std::vector<TupleLevel>& levels, std::vector<int>& tuple,
+                      unsigned int start, unsigned int end) const;
+
+    static unsigned int workerCount(unsigned int threads, unsigned int jobs);
+};
+
+#endif //DA_CONTINGENCY_H
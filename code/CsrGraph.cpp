@@ -0,0 +1,494 @@
+#include "CsrGraph.h"
+
+#include <unordered_map>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DA_AVX2
+
+/**
+ * Compares 8 consecutive capacities with zero using AVX2.\n\n
+ *
+ * @param values Pointer to the first of the 8 capacities.
+ *
+ * @return Bitmask where bit i is set if values[i] > 0.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+__attribute__((target("avx2")))
+static unsigned int positiveMaskAvx2(const int32_t* values) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    __m256i positive = _mm256_cmpgt_epi32(v, _mm256_setzero_si256());
+    return (unsigned int) _mm256_movemask_ps(_mm256_castsi256_ps(positive));
+}
+
+static bool supportsAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#else
+static bool supportsAvx2() {
+    return false;
+}
+#endif
+
+static const bool avx2 = supportsAvx2();
+
+/**
+ * Compares 8 consecutive capacities with zero, one at a time.\n\n
+ *
+ * @param values Pointer to the first of the 8 capacities.
+ *
+ * @return Bitmask where bit i is set if values[i] > 0.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+template <typename Capacity>
+static unsigned int positiveMaskScalar(const Capacity* values) {
+    unsigned int mask = 0;
+    for (int i = 0; i < 8; i++)
+        if (values[i] > 0) mask |= 1u << i;
+    return mask;
+}
+
+/**
+ * Compares 8 consecutive capacities with zero. Only the 32-bit capacities have a vectorised compare (see the int32_t
+ * overload), every other capacity type is compared one at a time.\n\n
+ *
+ * @param values Pointer to the first of the 8 capacities.
+ *
+ * @return Bitmask where bit i is set if values[i] > 0.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+template <typename Capacity>
+static unsigned int positiveMask(const Capacity* values) {
+    return positiveMaskScalar(values);
+}
+
+static unsigned int positiveMask(const int32_t* values) {
+#ifdef DA_AVX2
+    if (avx2) return positiveMaskAvx2(values);
+#endif
+    return positiveMaskScalar(values);
+}
+
+static int lowestBit(uint64_t bits) {
+#ifdef __GNUC__
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    while (!(bits & 1)) { bits >>= 1; i++; }
+    return i;
+#endif
+}
+
+static unsigned int countBits(uint64_t bits) {
+#ifdef __GNUC__
+    return __builtin_popcountll(bits);
+#else
+    unsigned int count = 0;
+    for (; bits; bits &= bits - 1) count++;
+    return count;
+#endif
+}
+
+template <typename Capacity>
+BasicCsrGraph<Capacity>::BasicCsrGraph() = default;
+
+/**
+ * Builds a compressed sparse row copy of a graph, where the edges of each vertex are stored contiguously and
+ * capacities, residual capacities and reverse edges are kept in flat arrays. An extra Super-Source vertex (with the
+ * last id) is connected to all the vertexes with only 1 outgoing edge, like the line ends used by Supervisor::lineEnds.
+ * The edge to a line end has the capacity of its only segment, which already bounds the flow that can leave it, so
+ * no edge has an unbounded capacity. The capacities are of type Capacity (int32_t for CsrGraph, int64_t for
+ * CsrGraph64) and the flow values saturate instead of overflowing (see CapacityTraits).\n\n
+ *
+ * @param graph The graph to copy.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+template <typename Capacity>
+BasicCsrGraph<Capacity>::BasicCsrGraph(const Graph& graph) {
+    const std::vector<Vertex*>& vertexSet = graph.getVertexSet();
+    n = vertexSet.size();
+    superSource = n;
+
+    std::vector<std::vector<Edge*>> adj;
+    for (Vertex* v : vertexSet)
+        adj.push_back(v->getAdj());
+
+    offset.assign(n + 2, 0);
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] = adj[v].size();
+        if (adj[v].size() == 1) {
+            offset[v + 1]++;
+            offset[superSource + 1]++;
+        }
+    }
+    for (int v = 0; v <= n; v++)
+        offset[v + 1] += offset[v];
+
+    int arcs = offset[n + 1];
+    target.assign(arcs, 0);
+    capacity.assign(arcs, 0);
+    reverse.assign(arcs, 0);
+    superArc.assign(n, -1);
+
+    std::vector<int> position(offset.begin(), offset.end() - 1);
+    std::unordered_map<const Edge*, int> arc;
+
+    for (int v = 0; v < n; v++)
+        for (Edge* e : adj[v]) {
+            int i = position[v]++;
+            arc[e] = i;
+            target[i] = e->getDest()->getId();
+            capacity[i] = e->getCapacity();
+        }
+    for (int v = 0; v < n; v++)
+        for (Edge* e : adj[v])
+            reverse[arc[e]] = arc[e->getReverse()];
+
+    for (int v = 0; v < n; v++)
+        if (adj[v].size() == 1) {
+            int in = position[v]++, out = position[superSource]++;
+            target[in] = superSource;
+            target[out] = v;
+            capacity[in] = capacity[out] = adj[v][0]->getCapacity();
+            reverse[in] = out;
+            reverse[out] = in;
+            superArc[v] = out;
+        }
+
+    residual = capacity;
+    parent.assign(n + 1, -1);
+    visited.assign((n + 64) / 64, 0);
+    frontier.assign(visited.size(), 0);
+    next.assign(visited.size(), 0);
+}
+
+/**
+ * @return The number of vertexes, including the Super-Source.
+ */
+template <typename Capacity>
+unsigned int BasicCsrGraph<Capacity>::getVertexCount() const {
+    return n + 1;
+}
+
+/**
+ * @return The identifier of the Super-Source.
+ */
+template <typename Capacity>
+int BasicCsrGraph<Capacity>::getSuperSource() const {
+    return superSource;
+}
+
+/**
+ * Lists the segments of the network, that is, one edge of each pair of opposite edges between two stations
+ * (the edges of the Super-Source are not segments).\n\n
+ *
+ * @return Vector with one edge index per segment.
+ *
+ * @par Time complexity
+ * O(E), where E is the number of edges in the graph.
+ */
+template <typename Capacity>
+std::vector<int> BasicCsrGraph<Capacity>::getSegments() const {
+    std::vector<int> segments;
+    for (int a = 0; a < offset[n]; a++)
+        if (target[a] != superSource && a < reverse[a])
+            segments.push_back(a);
+    return segments;
+}
+
+/**
+ * @param v The identifier of the vertex.
+ * @return The range [first, last) of the indexes of the edges leaving the vertex.
+ */
+template <typename Capacity>
+std::pair<int, int> BasicCsrGraph<Capacity>::getArcs(int v) const {
+    return std::make_pair(offset[v], offset[v + 1]);
+}
+
+template <typename Capacity>
+int BasicCsrGraph<Capacity>::getOrigin(int arc) const {
+    return target[reverse[arc]];
+}
+
+template <typename Capacity>
+int BasicCsrGraph<Capacity>::getTarget(int arc) const {
+    return target[arc];
+}
+
+template <typename Capacity>
+int BasicCsrGraph<Capacity>::getReverse(int arc) const {
+    return reverse[arc];
+}
+
+template <typename Capacity>
+Capacity BasicCsrGraph<Capacity>::getCapacity(int arc) const {
+    return capacity[arc];
+}
+
+/**
+ * @param arc The index of the edge.
+ * @return The flow sent through the edge by the last max flow (negative if it was sent the other way).
+ */
+template <typename Capacity>
+Capacity BasicCsrGraph<Capacity>::getFlow(int arc) const {
+    return capacity[arc] - residual[arc];
+}
+
+/**
+ * Changes the capacity of an edge, which is used as an overlay to simulate failures without building a new graph.
+ * The change applies from the next max flow on.\n\n
+ *
+ * @param arc The index of the edge.
+ * @param value The new capacity.
+ */
+template <typename Capacity>
+void BasicCsrGraph<Capacity>::setCapacity(int arc, Capacity value) {
+    capacity[arc] = value;
+}
+
+/**
+ * Changes the capacity of a segment for good, in both directions, together with the edges of the Super-Source to its
+ * ends that are line ends (whose capacity is the one of their only segment).\n\n
+ *
+ * @param arc The index of one edge of the segment.
+ * @param value The new capacity.
+ */
+template <typename Capacity>
+void BasicCsrGraph<Capacity>::setSegmentCapacity(int arc, Capacity value) {
+    for (int a : {arc, reverse[arc]}) {
+        capacity[a] = value;
+        int v = target[reverse[a]];
+        if (superArc[v] != -1)
+            capacity[superArc[v]] = capacity[reverse[superArc[v]]] = value;
+    }
+}
+
+template <typename Capacity>
+bool BasicCsrGraph<Capacity>::test(const std::vector<uint64_t>& set, int i) {
+    return (set[i >> 6] >> (i & 63)) & 1;
+}
+
+template <typename Capacity>
+void BasicCsrGraph<Capacity>::insert(std::vector<uint64_t>& set, int i) {
+    set[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+/**
+ * Builds a bitset of vertexes, with the same size as the visited set.\n\n
+ *
+ * @param ids The identifiers of the vertexes.
+ *
+ * @return Bitset where bit i is set if i belongs to ids.
+ *
+ * @par Time complexity
+ * O(V + k), where V is the number of vertexes and k the size of ids.
+ */
+template <typename Capacity>
+std::vector<uint64_t> BasicCsrGraph<Capacity>::makeSet(const std::vector<int>& ids) const {
+    std::vector<uint64_t> set(visited.size(), 0);
+    for (int id : ids)
+        if (id >= 0 && id <= n) insert(set, id);
+    return set;
+}
+
+/**
+ * Adds to the next frontier every unvisited neighbour of a vertex reachable through an edge with positive weight
+ * (and that belongs to the allowed set, if there is one). The weights are filtered 8 at a time with AVX2 when the
+ * CPU supports it.\n\n
+ *
+ * @param v The vertex to expand.
+ * @param weights Capacity of each edge (residual or original).
+ * @param allowed Bitset of vertexes that can be visited, or nullptr for all of them.
+ *
+ * @return True if any vertex was added to the next frontier, false otherwise.
+ *
+ * @par Time complexity
+ * O(d), where d is the number of edges of the vertex.
+ */
+template <typename Capacity>
+bool BasicCsrGraph<Capacity>::expand(int v, const Capacity* weights, const uint64_t* allowed) {
+    bool added = false;
+    int i = offset[v], end = offset[v + 1];
+
+    while (i < end) {
+        unsigned int mask = 0;
+        int width = std::min(8, end - i);
+        if (width == 8)
+            mask = positiveMask(weights + i);
+        else
+            for (int k = 0; k < width; k++)
+                if (weights[i + k] > 0) mask |= 1u << k;
+
+        for (; mask; mask &= mask - 1) {
+            int a = i + lowestBit(mask);
+            int w = target[a];
+            if (test(visited, w)) continue;
+            if (allowed != nullptr && !((allowed[w >> 6] >> (w & 63)) & 1)) continue;
+            insert(visited, w);
+            insert(next, w);
+            parent[w] = a;
+            added = true;
+        }
+        i += width;
+    }
+    return added;
+}
+
+/**
+ * Runs a level-synchronous BFS from a vertex, where the frontier and the visited vertexes are bitsets. Each level
+ * expands every vertex of the current frontier into the next one. Vertexes already in the visited set are not
+ * visited again, so several sweeps can share it.\n\n
+ *
+ * @param src The vertex where the search starts.
+ * @param dest The vertex where the search can stop, or -1 to visit everything reachable.
+ * @param weights Capacity of each edge (residual or original).
+ * @param allowed Bitset of vertexes that can be visited, or nullptr for all of them.
+ *
+ * @return The number of vertexes visited by this sweep, including src.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+template <typename Capacity>
+unsigned int BasicCsrGraph<Capacity>::sweep(int src, int dest, const Capacity* weights, const uint64_t* allowed) {
+    std::fill(frontier.begin(), frontier.end(), 0);
+    insert(visited, src);
+    insert(frontier, src);
+
+    unsigned int reached = 1;
+    bool grew = true;
+    while (grew && (dest == -1 || !test(visited, dest))) {
+        std::fill(next.begin(), next.end(), 0);
+        grew = false;
+        for (unsigned int w = 0; w < frontier.size(); w++)
+            for (uint64_t bits = frontier[w]; bits; bits &= bits - 1)
+                if (expand((int) (w * 64 + lowestBit(bits)), weights, allowed))
+                    grew = true;
+        for (uint64_t bits : next)
+            reached += countBits(bits);
+        frontier.swap(next);
+    }
+    return reached;
+}
+
+/**
+ * Augments the flow along the path found by the last sweep, by the minimum residual capacity along it.\n\n
+ *
+ * @param src The source vertex.
+ * @param dest The target vertex.
+ *
+ * @return The amount of flow added.
+ *
+ * @par Time complexity
+ * O(V), where V is the number of vertexes in the graph.
+ */
+template <typename Capacity>
+Capacity BasicCsrGraph<Capacity>::augment(int src, int dest) {
+    Capacity f = CapacityTraits<Capacity>::INFINITE;
+    for (int v = dest; v != src; v = target[reverse[parent[v]]])
+        f = std::min(f, residual[parent[v]]);
+    for (int v = dest; v != src; v = target[reverse[parent[v]]]) {
+        residual[parent[v]] = CapacityTraits<Capacity>::subtract(residual[parent[v]], f);
+        residual[reverse[parent[v]]] = CapacityTraits<Capacity>::add(residual[reverse[parent[v]]], f);
+    }
+    return f;
+}
+
+/**
+ * Finds the maximum flow between two vertexes with the Edmonds-Karp algorithm, using the bitset BFS to find the
+ * augmenting paths. The Super-Source is never crossed.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ *
+ * @return The maximum flow from the source vertex to the target vertex.
+ *
+ * @par Time complexity
+ * O(V * E²), where V is the number of vertexes and E the number of edges in the graph.
+ */
+template <typename Capacity>
+Capacity BasicCsrGraph<Capacity>::maxFlow(int source, int target) {
+    if (source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return 0;
+
+    residual = capacity;
+    Capacity flow = 0;
+    while (true) {
+        std::fill(visited.begin(), visited.end(), 0);
+        insert(visited, superSource);
+        sweep(source, target, residual.data(), nullptr);
+        if (!test(visited, target)) break;
+        flow = CapacityTraits<Capacity>::add(flow, augment(source, target));
+        if (flow == CapacityTraits<Capacity>::INFINITE) break;
+    }
+    return flow;
+}
+
+/**
+ * Finds the maximum flow from the Super-Source to a vertex, that is, the maximum number of trains that can arrive
+ * at a station from the ends of the network. The target itself is not used as a source.\n\n
+ *
+ * @param target The identifier of the target vertex.
+ *
+ * @return The maximum flow from the Super-Source to the target vertex.
+ *
+ * @par Time complexity
+ * O(V * E²), where V is the number of vertexes and E the number of edges in the graph.
+ */
+template <typename Capacity>
+Capacity BasicCsrGraph<Capacity>::superSourceFlow(int target) {
+    if (target < 0 || target >= n)
+        return 0;
+
+    residual = capacity;
+    if (superArc[target] != -1) {
+        residual[superArc[target]] = 0;
+        residual[reverse[superArc[target]]] = 0;
+    }
+
+    Capacity flow = 0;
+    while (true) {
+        std::fill(visited.begin(), visited.end(), 0);
+        sweep(superSource, target, residual.data(), nullptr);
+        if (!test(visited, target)) break;
+        flow = CapacityTraits<Capacity>::add(flow, augment(superSource, target));
+        if (flow == CapacityTraits<Capacity>::INFINITE) break;
+    }
+    return flow;
+}
+
+/**
+ * Calculates the size of the largest connected component formed only by the given vertexes (e.g. the stations of a
+ * district or municipality), sweeping once from every vertex of the set not yet visited.\n\n
+ *
+ * @param members Bitset of vertexes (see makeSet).
+ *
+ * @return Number of vertexes of the largest connected component.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+template <typename Capacity>
+unsigned int BasicCsrGraph<Capacity>::largestComponent(const std::vector<uint64_t>& members) {
+    std::fill(visited.begin(), visited.end(), 0);
+    unsigned int largest = 0;
+    for (unsigned int w = 0; w < members.size(); w++)
+        for (uint64_t bits = members[w]; bits; bits &= bits - 1) {
+            int v = (int) (w * 64 + lowestBit(bits));
+            if (!test(visited, v))
+                largest = std::max(largest, sweep(v, -1, capacity.data(), members.data()));
+        }
+    return largest;
+}
+
+template class BasicCsrGraph<int32_t>;
+template class BasicCsrGraph<int64_t>;
@@ -0,0 +1,64 @@
+#ifndef DA_CSRGRAPH_H
+#define DA_CSRGRAPH_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Graph.h"
+#include "Capacity.h"
+
+template <typename Capacity>
+class BasicCsrGraph {
+public:
+    BasicCsrGraph();
+    explicit BasicCsrGraph(const Graph& graph);
+
+    Capacity maxFlow(int source, int target);
+    Capacity superSourceFlow(int target);
+
+    std::vector<uint64_t> makeSet(const std::vector<int>& ids) const;
+    unsigned int largestComponent(const std::vector<uint64_t>& members);
+
+    unsigned int getVertexCount() const;
+    int getSuperSource() const;
+
+    std::vector<int> getSegments() const;
+    std::pair<int, int> getArcs(int v) const;
+    int getOrigin(int arc) const;
+    int getTarget(int arc) const;
+    int getReverse(int arc) const;
+    Capacity getCapacity(int arc) const;
+    Capacity getFlow(int arc) const;
+
+    void setCapacity(int arc, Capacity value);
+    void setSegmentCapacity(int arc, Capacity value);
+
+private:
+    int n = 0;
+    int superSource = 0;
+
+    std::vector<int> offset;
+    std::vector<int> target;
+    std::vector<Capacity> capacity;
+    std::vector<Capacity> residual;
+    std::vector<int> reverse;
+    std::vector<int> superArc;
+
+    std::vector<int> parent;
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> frontier;
+    std::vector<uint64_t> next;
+
+    static bool test(const std::vector<uint64_t>& set, int i);
+    static void insert(std::vector<uint64_t>& set, int i);
+
+    bool expand(int v, const Capacity* weights, const uint64_t* allowed);
+    unsigned int sweep(int src, int dest, const Capacity* weights, const uint64_t* allowed);
+
+    Capacity augment(int src, int dest);
+};
+
+typedef BasicCsrGraph<int32_t> CsrGraph;
+typedef BasicCsrGraph<int64_t> CsrGraph64;
+
+#endif //DA_CSRGRAPH_H
@@ -0,0 +1,143 @@
+#include "CsvReader.h"
+
+#include <charconv>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps a CSV file into memory, so its fields can be read in place without copying the file into strings.
+ * If the file does not exist or is empty, the reader has no rows.\n\n
+ *
+ * @param path Path of the CSV file.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+CsvReader::CsvReader(const std::string& path) {
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) return;
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data != nullptr) size = fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return;
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(map);
+            size = info.st_size;
+        }
+    }
+    close(fd);
+#endif
+}
+
+CsvReader::~CsvReader() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != nullptr) CloseHandle(file);
+#else
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+#endif
+}
+
+/**
+ * Reads the next row of the file, splitting it by commas. A field between quotes may contain commas and is returned
+ * without the quotes. The fields point into the mapped file, so they are only valid while the reader exists.
+ * Empty lines are skipped and the '\\r' of Windows line endings is removed.\n\n
+ *
+ * @param fields Vector where the fields of the row are stored.
+ *
+ * @return True if a row was read, false at the end of the file.
+ *
+ * @par Time complexity
+ * O(n), where n is the length of the row
+ */
+bool CsvReader::readRow(std::vector<std::string_view>& fields) {
+    fields.clear();
+
+    while (pos < size && (data[pos] == '\n' || data[pos] == '\r'))
+        pos++;
+    if (pos >= size) return false;
+
+    while (true) {
+        size_t start = pos, end;
+        if (data[pos] == '\"') {
+            start = ++pos;
+            while (pos < size && data[pos] != '\"') pos++;
+            end = pos;
+            if (pos < size) pos++;
+            while (pos < size && data[pos] != ',' && data[pos] != '\n') pos++;
+        }
+        else {
+            while (pos < size && data[pos] != ',' && data[pos] != '\n') pos++;
+            end = pos;
+        }
+
+        if (end > start && (pos >= size || data[pos] == '\n') && data[end - 1] == '\r')
+            end--;
+        fields.emplace_back(data + start, end - start);
+
+        if (pos < size && data[pos] == ',') {
+            pos++;
+            continue;
+        }
+        if (pos < size) pos++;
+        return true;
+    }
+}
+
+/**
+ * Returns a string with the content of a field, creating it only the first time that content is read, so the
+ * station names repeated along the file are only copied once.\n\n
+ *
+ * @param field The field to intern.
+ *
+ * @return Reference to the interned string, valid while the reader exists.
+ *
+ * @par Time complexity
+ * O(n), where n is the length of the field
+ */
+const std::string& CsvReader::intern(std::string_view field) {
+    auto it = interned.find(field);
+    if (it != interned.end())
+        return *it->second;
+    pool.emplace_back(field);
+    const std::string& s = pool.back();
+    interned.emplace(std::string_view(s), &s);
+    return s;
+}
+
+/**
+ * Converts a numeric field to an integer.\n\n
+ *
+ * @param field The field to convert.
+ *
+ * @return The value of the field, or 0 if it is not a number.
+ *
+ * @par Time complexity
+ * O(n), where n is the length of the field
+ */
+int CsvReader::toInt(std::string_view field) {
+    int value = 0;
+    std::from_chars(field.data(), field.data() + field.size(), value);
+    return value;
+}
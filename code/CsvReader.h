@@ -0,0 +1,37 @@
+#ifndef DA_CSVREADER_H
+#define DA_CSVREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+class CsvReader {
+public:
+    explicit CsvReader(const std::string& path);
+    ~CsvReader();
+
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    bool readRow(std::vector<std::string_view>& fields);
+    const std::string& intern(std::string_view field);
+
+    static int toInt(std::string_view field);
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+
+    std::deque<std::string> pool;
+    std::unordered_map<std::string_view, const std::string*> interned;
+};
+
+#endif //DA_CSVREADER_H
@@ -0,0 +1,157 @@
+#include "CutTree.h"
+
+#include <thread>
+#include <atomic>
+#include <numeric>
+
+#include "BridgeIndex.h"
+
+CutTree::CutTree() = default;
+
+/**
+ * Builds a flow-equivalent tree of an undirected network: a tree on the same stations where the max flow between
+ * two stations is the smallest capacity on the path between them, so every pair is answered from n - 1 max flows.
+ * Each 2-edge-connected component gets its own tree with Gusfield's algorithm (stations of a component only need
+ * max flows inside it), and the bridges join those trees with their own capacity, as in BridgeIndex::maxFlow.
+ * The components are shared between the threads, largest first, each thread with its own copy of the network
+ * (read before the threads start, since reading the network is not thread safe).\n\n
+ *
+ * @param network Function that reads a new copy of the network.
+ * @param threads Number of threads (0 for the number of cores).
+ *
+ * @par Time complexity
+ * O(V * C * E² / p), where V is the number of stations, C and E the vertexes and edges of the largest
+ * 2-edge-connected component and p the threads
+ */
+CutTree::CutTree(const std::function<Graph()>& network, unsigned int threads) {
+    Graph graph = network();
+    BridgeIndex bridgeIndex(graph);
+    n = (int) graph.getVertexSet().size();
+    adj.assign(n, {});
+
+    std::vector<std::vector<int>> members(bridgeIndex.getComponentCount());
+    for (int v = 0; v < n; v++)
+        members[bridgeIndex.getComponent(v)].push_back(v);
+    std::sort(members.begin(), members.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
+        return a.size() > b.size();
+    });
+    while (!members.empty() && members.back().size() < 2)
+        members.pop_back();
+
+    for (Vertex* v : graph.getVertexSet())
+        for (Edge* e : v->getAdj())
+            if (bridgeIndex.isBridge(e) && v->getId() < e->getDest()->getId())
+                addEdge(v->getId(), e->getDest()->getId(), e->getCapacity());
+
+    std::vector<int> treeParent(n, -1), flow(n, 0);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int workers = std::max(1u, std::min(threads, (unsigned int) members.size()));
+    std::vector<Graph> graphs;
+    for (unsigned int w = 0; w < workers; w++)
+        graphs.push_back(network());
+
+    std::atomic<unsigned int> next(0);
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < workers; w++)
+        pool.emplace_back([&, w]() {
+            BridgeIndex index(graphs[w]);
+            std::vector<int> side;
+            std::vector<char> inSide(n, 0);
+            for (unsigned int c = next++; c < members.size(); c = next++) {
+                const std::vector<int>& component = members[c];
+                for (unsigned int i = 1; i < component.size(); i++)
+                    treeParent[component[i]] = component[0];
+
+                for (unsigned int i = 1; i < component.size(); i++) {
+                    int s = component[i], t = treeParent[s];
+                    flow[s] = index.componentCut(s, t, side);
+                    for (int v : side) inSide[v] = 1;
+                    for (unsigned int j = i + 1; j < component.size(); j++)
+                        if (inSide[component[j]] && treeParent[component[j]] == t)
+                            treeParent[component[j]] = s;
+                    for (int v : side) inSide[v] = 0;
+                }
+            }
+        });
+    for (auto& worker : pool)
+        worker.join();
+
+    for (int v = 0; v < n; v++)
+        if (treeParent[v] != -1)
+            addEdge(v, treeParent[v], flow[v]);
+}
+
+/**
+ * Adds an edge to the tree.\n\n
+ *
+ * @param a One end of the edge.
+ * @param b The other end.
+ * @param flow Max flow between both ends.
+ */
+void CutTree::addEdge(int a, int b, int flow) {
+    adj[a].emplace_back(b, flow);
+    adj[b].emplace_back(a, flow);
+}
+
+/**
+ * @param source Source station id.
+ * @param target Target station id.
+ *
+ * @return Max flow between the two stations: the smallest flow on the path of the tree between them, 0 if there is
+ * no path.
+ *
+ * @par Time complexity
+ * O(V), where V is the number of stations
+ */
+int CutTree::maxFlow(int source, int target) const {
+    if (source == target || source < 0 || target < 0 || source >= n || target >= n) return 0;
+
+    std::vector<int> best(n, -1);
+    std::vector<int> stack = {source};
+    best[source] = INF;
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        if (v == target) return best[v];
+        for (const auto& edge : adj[v])
+            if (best[edge.first] == -1) {
+                best[edge.first] = std::min(best[v], edge.second);
+                stack.push_back(edge.first);
+            }
+    }
+    return 0;
+}
+
+/**
+ * Finds the pairs of stations with the largest max flow of the network. That flow is the largest one in the tree,
+ * and the pairs are the stations joined by edges with exactly that flow, so no max flow is computed.\n\n
+ *
+ * @param pairs Vector where the pairs (source < target) are stored, in ascending order.
+ *
+ * @return The largest max flow between two stations.
+ *
+ * @par Time complexity
+ * O(V²), where V is the number of stations
+ */
+int CutTree::busiestPairs(std::vector<std::pair<int, int>>& pairs) const {
+    pairs.clear();
+    int best = 0;
+    for (int v = 0; v < n; v++)
+        for (const auto& edge : adj[v])
+            best = std::max(best, edge.second);
+    if (best == 0) return 0;
+
+    std::vector<int> group(n);
+    std::iota(group.begin(), group.end(), 0);
+    std::function<int(int)> find = [&](int v) { return group[v] == v ? v : group[v] = find(group[v]); };
+    for (int v = 0; v < n; v++)
+        for (const auto& edge : adj[v])
+            if (edge.second == best)
+                group[find(v)] = find(edge.first);
+
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            if (find(i) == find(j))
+                pairs.emplace_back(i, j);
+    return best;
+}
@@ -0,0 +1,24 @@
+#ifndef DA_CUTTREE_H
+#define DA_CUTTREE_H
+
+#include <vector>
+#include <functional>
+
+#include "Graph.h"
+
+class CutTree {
+public:
+    CutTree();
+    CutTree(const std::function<Graph()>& network, unsigned int threads);
+
+    int maxFlow(int source, int target) const;
+    int busiestPairs(std::vector<std::pair<int, int>>& pairs) const;
+
+private:
+    int n = 0;
+    std::vector<std::vector<std::pair<int, int>>> adj;
+
+    void addEdge(int a, int b, int flow);
+};
+
+#endif //DA_CUTTREE_H
@@ -0,0 +1,274 @@
+#include "FlowMatrix.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <limits>
+
+#include "BridgeIndex.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = {'D', 'A', 'F', 'M'};
+static const uint32_t VERSION = 3;
+
+FlowMatrix::~FlowMatrix() {
+    close();
+}
+
+/**
+ * Maps a flow matrix file into memory. The file is only used if it was built for the same network, i.e. if its hash
+ * is the given one; otherwise (or if it does not exist) the matrix stays closed and the queries must be computed.\n\n
+ *
+ * @param path Path of the matrix file.
+ * @param hash Hash of the current network (see networkHash).
+ *
+ * @return True if the matrix can be used, false otherwise.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+bool FlowMatrix::open(const std::string& path, uint64_t hash) {
+    close();
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (data != nullptr) size = fileSize.QuadPart;
+        }
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            data = static_cast<const char*>(map);
+            size = info.st_size;
+        }
+    }
+    ::close(fd);
+#endif
+
+    Header header{};
+    if (data == nullptr || size < sizeof(Header)) {
+        close();
+        return false;
+    }
+    memcpy(&header, data, sizeof(Header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.hash != hash ||
+        size != sizeof(Header) + pairCount(header.stations) * sizeof(uint16_t)) {
+        close();
+        return false;
+    }
+
+    stations = header.stations;
+    flows = reinterpret_cast<const uint16_t*>(data + sizeof(Header));
+    return true;
+}
+
+/**
+ * Unmaps the matrix file, if it is open.\n\n
+ *
+ * @par Time complexity
+ * O(1)
+ */
+void FlowMatrix::close() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != nullptr) CloseHandle(file);
+    file = nullptr;
+    mapping = nullptr;
+#else
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+    stations = 0;
+    flows = nullptr;
+}
+
+/**
+ * @return True if the matrix was built for the current network and can answer queries, false otherwise.
+ */
+bool FlowMatrix::isOpen() const {
+    return flows != nullptr;
+}
+
+/**
+ * @param source Source station id.
+ * @param target Target station id.
+ *
+ * @return Max flow between the two stations of the intact network (the same value as BridgeIndex::maxFlow).
+ *
+ * @par Time complexity
+ * O(1)
+ */
+int FlowMatrix::maxFlow(int source, int target) const {
+    if (source == target || source < 0 || target < 0 || source >= stations || target >= stations) return 0;
+    return flows[pairIndex(stations, source, target)];
+}
+
+/**
+ * Finds the pairs of stations with the largest max flow of the network.\n\n
+ *
+ * @param pairs Vector where the pairs (source < target) are stored.
+ *
+ * @return The largest max flow between two stations.
+ *
+ * @par Time complexity
+ * O(V²), where V is the number of stations
+ */
+int FlowMatrix::busiestPairs(std::vector<std::pair<int, int>>& pairs) const {
+    pairs.clear();
+    int best = 0;
+    size_t index = 0;
+    for (int i = 0; i < stations; i++)
+        for (int j = i + 1; j < stations; j++, index++) {
+            int flow = flows[index];
+            if (flow > best) {
+                best = flow;
+                pairs.clear();
+            }
+            if (flow == best && flow != 0) pairs.emplace_back(i, j);
+        }
+    return best;
+}
+
+/**
+ * Hashes a network: its stations, in id order, and the segments of each one with their capacity and service. Any
+ * change to the CSV files that changes the graph changes the hash, so a matrix of an older network is never used.\n\n
+ *
+ * @param graph The network.
+ *
+ * @return 64-bit FNV-1a hash of the network.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph
+ */
+uint64_t FlowMatrix::networkHash(const Graph& graph) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            hash ^= static_cast<const unsigned char*>(bytes)[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (auto v : graph.getVertexSet()) {
+        std::string name = v->getStation().getName();
+        int id = v->getId();
+        add(&id, sizeof(id));
+        add(name.c_str(), name.size() + 1);
+        for (auto e : v->getAdj()) {
+            int dest = e->getDest()->getId(), capacity = e->getCapacity();
+            std::string service = serviceInfo(e->getService()).name;
+            add(&dest, sizeof(dest));
+            add(&capacity, sizeof(capacity));
+            add(service.c_str(), service.size() + 1);
+        }
+    }
+    return hash;
+}
+
+/**
+ * Computes the max flow of every pair of stations of a network and writes them to a matrix file, that open maps
+ * later. Each thread works on its own copies of the network (read before the threads start, since
+ * reading the network is not thread safe) and on an interleaved share of the rows.
+ * The flow is symmetric, so only the upper triangle is stored, as uint16.
+ * The file is written to a temporary path and then renamed, so an interrupted build never leaves a partial matrix.\n\n
+ *
+ * @param network Function that reads a new copy of the network.
+ * @param path Path of the matrix file.
+ * @param threads Number of threads (0 for the number of cores).
+ *
+ * @return True if the matrix was written, false if a flow does not fit in 16 bits or the file cannot be written.
+ *
+ * @par Time complexity
+ * O(V² * (D + C * E²) / p), where D is the depth of the bridge forest, C and E the vertexes and edges of the largest
+ * 2-edge-connected component and p the threads
+ */
+bool FlowMatrix::build(const std::function<Graph()>& network, const std::string& path, unsigned int threads) {
+    Graph graph = network();
+    int n = (int) graph.getVertexSet().size();
+    std::vector<uint16_t> flowValues(pairCount(n), 0);
+    std::atomic<bool> fits(true);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int workers = std::max(1u, std::min(threads, (unsigned int) n));
+    std::vector<Graph> graphs;
+    for (unsigned int w = 0; w < workers; w++)
+        graphs.push_back(network());
+
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < workers; w++)
+        pool.emplace_back([&, w]() {
+            BridgeIndex bridgeIndex(graphs[w]);
+            for (int i = (int) w; i < n; i += (int) workers)
+                for (int j = i + 1; j < n; j++) {
+                    int flow = bridgeIndex.maxFlow(i, j);
+                    if (flow > std::numeric_limits<uint16_t>::max()) {
+                        fits = false;
+                        return;
+                    }
+                    flowValues[pairIndex(n, i, j)] = (uint16_t) flow;
+                }
+        });
+    for (auto& worker : pool)
+        worker.join();
+    if (!fits) return false;
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.hash = networkHash(graph);
+    header.stations = n;
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(flowValues.data()), (std::streamsize) (flowValues.size() * sizeof(uint16_t)));
+        if (!out) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @return Position of the pair in the upper triangle of the matrix, stored row by row.
+ */
+size_t FlowMatrix::pairIndex(int stations, int source, int target) {
+    if (source > target) std::swap(source, target);
+    return (size_t) source * (2 * (size_t) stations - source - 1) / 2 + (target - source - 1);
+}
+
+/**
+ * @return Number of pairs of different stations.
+ */
+size_t FlowMatrix::pairCount(int stations) {
+    return (size_t) stations * (stations - 1) / 2;
+}
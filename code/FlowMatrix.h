@@ -0,0 +1,54 @@
+#ifndef DA_FLOWMATRIX_H
+#define DA_FLOWMATRIX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "Graph.h"
+
+#define FLOW_MATRIX "../data/flows.bin"
+
+class FlowMatrix {
+public:
+    FlowMatrix() = default;
+    ~FlowMatrix();
+
+    FlowMatrix(const FlowMatrix&) = delete;
+    FlowMatrix& operator=(const FlowMatrix&) = delete;
+
+    bool open(const std::string& path, uint64_t hash);
+    void close();
+    bool isOpen() const;
+
+    int maxFlow(int source, int target) const;
+    int busiestPairs(std::vector<std::pair<int, int>>& pairs) const;
+
+    static uint64_t networkHash(const Graph& graph);
+    static bool build(const std::function<Graph()>& network, const std::string& path, unsigned int threads);
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t hash;
+        uint32_t stations;
+        uint32_t padding;
+    };
+
+    const char* data = nullptr;
+    size_t size = 0;
+    int stations = 0;
+    const uint16_t* flows = nullptr;
+
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+
+    static size_t pairIndex(int stations, int source, int target);
+    static size_t pairCount(int stations);
+};
+
+#endif //DA_FLOWMATRIX_H
@@ -1,6 +1,7 @@
 #include "Graph.h"
 
 Vertex * Graph::findVertex(const int &id) const {
+    if (id < 0 || id >= (int) vertexSet.size()) return nullptr;
     return vertexSet[id];
 }
 
@@ -8,23 +9,116 @@ void Graph::addVertex(const int &id, Station station) {
     auto* v = new Vertex(id);
     v->setStation(std::move(station));
     vertexSet.push_back(v);
+    landmarks = Landmarks();
 }
 
-void Graph::addEdge(const int &source, const int &dest, int capacity, const std::string& service) const {
+Edge * Graph::addEdge(const int &source, const int &dest, int capacity, Service service, int duration) {
     auto v1 = findVertex(source);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
-        return;
-    auto e1 = v1->addEdge(v2, capacity/2, service);
-    auto e2 = v2->addEdge(v1, capacity/2, service);
+        return nullptr;
+    auto e1 = v1->addEdge(v2, capacity, service);
+    auto e2 = v2->addEdge(v1, capacity, service);
+    e1->setDuration(duration);
+    e2->setDuration(duration);
     e1->setReverse(e2);
     e2->setReverse(e1);
+    landmarks = Landmarks();
+    return e1;
 }
 
-std::vector<Vertex *> Graph::getVertexSet() const {
+/**
+ * Finds a segment between two vertexes. Parallel segments are kept in the order they were added, so the same index
+ * gives the same segment in every graph read from the same file.\n\n
+ *
+ * @param source The identifier of one end of the segment.
+ * @param dest The identifier of the other end.
+ * @param parallel Index of the segment among the segments between the two vertexes (0 for the first one).
+ *
+ * @return The edge from source to dest, nullptr if there is no such segment between them.
+ *
+ * @par Time complexity
+ * O(d), where d is the degree of the source vertex.
+ */
+Edge * Graph::findEdge(int source, int dest, unsigned int parallel) const {
+    if (source < 0 || source >= (int) vertexSet.size()) return nullptr;
+    for (Edge* e : vertexSet[source]->getAdj())
+        if (e->getDest()->getId() == dest && parallel-- == 0)
+            return e;
+    return nullptr;
+}
+
+/**
+ * @param source The identifier of one vertex.
+ * @param dest The identifier of the other vertex.
+ *
+ * @return The number of segments between the two vertexes (more than 1 for parallel segments).
+ *
+ * @par Time complexity
+ * O(d), where d is the degree of the source vertex.
+ */
+unsigned int Graph::segmentCount(int source, int dest) const {
+    if (source < 0 || source >= (int) vertexSet.size()) return 0;
+    unsigned int count = 0;
+    for (Edge* e : vertexSet[source]->getAdj())
+        if (e->getDest()->getId() == dest)
+            count++;
+    return count;
+}
+
+/**
+ * Changes the capacity of a segment, in both directions. The landmarks stay valid, since they only depend on the
+ * costs.\n\n
+ *
+ * @param edge One direction of the segment.
+ * @param capacity The new capacity.
+ */
+void Graph::setSegmentCapacity(Edge *edge, int capacity) {
+    edge->setCapacity(capacity);
+    edge->getReverse()->setCapacity(capacity);
+}
+
+/**
+ * Removes a segment, in both directions; its vertexes are kept even if they become isolated. The landmarks stay
+ * valid, since removing a segment can only make the costs between stations larger.\n\n
+ *
+ * @param edge One direction of the segment (deleted, like its reverse).
+ *
+ * @par Time complexity
+ * O(d), where d is the degree of its vertexes.
+ */
+void Graph::removeSegment(Edge *edge) {
+    Edge* reverse = edge->getReverse();
+    edge->getOrig()->removeEdge(edge);
+    reverse->getOrig()->removeEdge(reverse);
+}
+
+const std::vector<Vertex *>& Graph::getVertexSet() const {
     return this->vertexSet;
 }
 
+const Landmarks& Graph::getLandmarks() const {
+    return this->landmarks;
+}
+
+/**
+ * Precomputes the landmarks of the graph, used as lower bounds by the cheapest path searches of KShortestPaths.
+ * Adding a vertex or an edge with addVertex or addEdge drops them, so they must be built again after the graph is
+ * complete; graphs changed through their vertexes (like the reduced graph of ChainContraction) must not build them.\n\n
+ *
+ * @param count The number of landmarks.
+ *
+ * @par Time complexity
+ * O(L * (V + E) * log(V)), where L is the number of landmarks, V the number of vertexes and E the number of edges
+ */
+void Graph::buildLandmarks(unsigned int count) {
+    landmarks = Landmarks(vertexSet, count);
+}
+
+unsigned long Graph::getExploredVertices() const {
+    return this->exploredVertices;
+}
+
 /**
  * @brief Finds the shortest augmenting path from the source to the target using a BFS.
  *
@@ -45,21 +139,20 @@ bool Graph::findAugmentingPath(Vertex* src, Vertex* dest){
 
     src->setVisited(true);
 
-    std::queue<Vertex*> queue;
-    queue.push(src);
+    searchQueue.clear();
+    searchQueue.push_back(src);
 
-    while (!queue.empty() && !dest->isVisited()){
-        Vertex* v = queue.front();
-        queue.pop();
+    for (size_t head = 0; head < searchQueue.size() && !dest->isVisited(); head++){
+        Vertex* v = searchQueue[head];
 
         for (Edge* e: v->getAdj()) {
             Vertex* w = e->getDest();
-            if (w->getStation().getName() == "Super-Source") continue;
             int residual = e->getResidualCapacity();
             if (!w->isVisited() && residual > 0) {
                 w->setVisited(true);
                 w->setPath(e);
-                queue.push(w);
+                exploredVertices++;
+                searchQueue.push_back(w);
             }
         }
     }
@@ -67,6 +160,94 @@ bool Graph::findAugmentingPath(Vertex* src, Vertex* dest){
     return dest->isVisited();
 }
 
+/**
+ * @brief Finds a shortest augmenting path from the source to the target using a bidirectional BFS.
+ *
+ * This function grows two BFS trees level by level, always expanding the smaller frontier: one from the source
+ * over the residual edges and one from the target over the reverse residual edges. The search stops as soon as
+ * both trees reach a common vertex, and the backward half of the path is then stored in the path of each vertex,
+ * so the path can be walked from the target to the source like the one found by findAugmentingPath.\n\n
+ *
+ * @param src A pointer to the source vertex.
+ * @param dest A pointer to the target vertex.
+ *
+ * @return True if a path from the source to the target was found, false otherwise.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+bool Graph::findBidirectionalAugmentingPath(Vertex* src, Vertex* dest){
+    for (Vertex* v : vertexSet) {
+        v->setVisited(false);
+        v->setSinkVisited(false);
+    }
+
+    src->setVisited(true);
+    dest->setSinkVisited(true);
+
+    searchQueue.clear();
+    backwardQueue.clear();
+    searchQueue.push_back(src);
+    backwardQueue.push_back(dest);
+    size_t forwardHead = 0, backwardHead = 0;
+
+    Vertex* meeting = nullptr;
+
+    while (meeting == nullptr && forwardHead < searchQueue.size() && backwardHead < backwardQueue.size()){
+        if (searchQueue.size() - forwardHead <= backwardQueue.size() - backwardHead) {
+            for (auto level = searchQueue.size() - forwardHead; level > 0 && meeting == nullptr; level--) {
+                Vertex* v = searchQueue[forwardHead++];
+
+                for (Edge* e: v->getAdj()) {
+                    Vertex* w = e->getDest();
+                    if (!w->isVisited() && e->getResidualCapacity() > 0) {
+                        w->setVisited(true);
+                        w->setPath(e);
+                        exploredVertices++;
+                        if (w->isSinkVisited()) {
+                            meeting = w;
+                            break;
+                        }
+                        searchQueue.push_back(w);
+                    }
+                }
+            }
+        }
+        else {
+            for (auto level = backwardQueue.size() - backwardHead; level > 0 && meeting == nullptr; level--) {
+                Vertex* v = backwardQueue[backwardHead++];
+
+                for (Edge* e: v->getAdj()) {
+                    Vertex* w = e->getDest();
+                    Edge* residualEdge = e->getReverse();
+                    if (!w->isSinkVisited() && residualEdge->getResidualCapacity() > 0) {
+                        w->setSinkVisited(true);
+                        w->setNext(residualEdge);
+                        exploredVertices++;
+                        if (w->isVisited()) {
+                            meeting = w;
+                            break;
+                        }
+                        backwardQueue.push_back(w);
+                    }
+                }
+            }
+        }
+    }
+
+    if (meeting == nullptr)
+        return false;
+
+    for (Vertex* v = meeting; v != dest;) {
+        Edge* e = v->getNext();
+        v = e->getDest();
+        v->setPath(e);
+        v->setVisited(true);
+    }
+
+    return true;
+}
+
 /**
  * @brief Finds the minimum residual capacity along the chosen augmenting path from the source to the target.
  *
@@ -127,13 +308,14 @@ void Graph::augmentFlowAlongPath(Vertex *src, Vertex *dest, int flow){
  *
  * @param source The identifier of the source vertex.
  * @param target The identifier of the target vertex.
+ * @param bidirectional True to search the augmenting paths from both ends (findBidirectionalAugmentingPath).
  *
  * @return The maximum flow from the source vertex to the target vertex.
  *
  * @par Time complexity
  * O(V * E²), where V is the number of vertexes and E the number of edges in the graph.
  */
-int Graph::maxFlow(int source, int target){
+int Graph::maxFlow(int source, int target, bool bidirectional){
 
     Vertex* src = findVertex(source);
     Vertex* dest = findVertex(target);
@@ -145,8 +327,9 @@ int Graph::maxFlow(int source, int target){
     for (Vertex* vertex : vertexSet)
         for (Edge* edge : vertex->getAdj())
             edge->setResidualCapacity(edge->getCapacity());
+    terminalFlow.clear();
 
-    while (findAugmentingPath(src,dest)) {
+    while (bidirectional ? findBidirectionalAugmentingPath(src, dest) : findAugmentingPath(src,dest)) {
         auto f = findMinResidualAlongPath(src, dest);
         augmentFlowAlongPath(src, dest, f);
         flow+=f;
@@ -155,12 +338,567 @@ int Graph::maxFlow(int source, int target){
     return flow;
 }
 
+/**
+ * @brief Converts a set of terminals into the capacity left at each vertex.
+ *
+ * @param terminals Map of vertex identifier to capacity of the terminal (INF for no limit).
+ * @param exclude Capacity of each vertex as a terminal of the other kind; those vertexes are left out.
+ *
+ * @return The capacity of each vertex as a terminal, 0 for the vertexes that are not terminals.
+ *
+ * @par Time complexity
+ * O(V + T), where V is the number of vertexes and T the number of terminals.
+ */
+std::vector<int> Graph::terminalCapacities(const std::unordered_map<int, int>& terminals, const std::vector<int>& exclude) const {
+    std::vector<int> left(vertexSet.size(), 0);
+    for (const auto& terminal : terminals)
+        if (terminal.first >= 0 && terminal.first < (int) vertexSet.size() && terminal.second > 0)
+            if (exclude.empty() || exclude[terminal.first] == 0)
+                left[terminal.first] = terminal.second;
+    return left;
+}
+
+/**
+ * @brief Finds the shortest augmenting path from any source to any sink using a BFS.
+ *
+ * This function works like findAugmentingPath on a graph with a super source connected to every source and a super
+ * sink connected to every sink, without adding them: the BFS starts from all the sources that can still send flow
+ * and stops at the first sink that can still receive it.\n\n
+ *
+ * @param sourceLeft Capacity left at each vertex as a source.
+ * @param sinkLeft Capacity left at each vertex as a sink.
+ * @param src Set to the source where the path starts.
+ * @param dest Set to the sink where the path ends.
+ *
+ * @return True if a path from a source to a sink was found, false otherwise.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+bool Graph::findTerminalAugmentingPath(const std::vector<int>& sourceLeft, const std::vector<int>& sinkLeft, Vertex*& src, Vertex*& dest){
+    searchQueue.clear();
+    for (Vertex* v : vertexSet) {
+        v->setVisited(sourceLeft[v->getId()] > 0);
+        v->setPath(nullptr);
+        if (v->isVisited())
+            searchQueue.push_back(v);
+    }
+
+    for (size_t head = 0; head < searchQueue.size(); head++){
+        Vertex* v = searchQueue[head];
+
+        for (Edge* e: v->getAdj()) {
+            Vertex* w = e->getDest();
+            if (!w->isVisited() && e->getResidualCapacity() > 0) {
+                w->setVisited(true);
+                w->setPath(e);
+                exploredVertices++;
+                if (sinkLeft[w->getId()] > 0) {
+                    dest = w;
+                    for (src = w; src->getPath() != nullptr; src = src->getPath()->getOrig());
+                    return true;
+                }
+                searchQueue.push_back(w);
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Finds the minimum cost augmenting path from any source to any sink.
+ *
+ * This function works like findMinCostAugmentingPath on a graph with a super source connected to every source and a
+ * super sink connected to every sink, without adding them: Dijkstra's algorithm starts from all the sources that can
+ * still send flow at cost 0, and the sink that can still receive flow with the lowest path cost is chosen.\n\n
+ *
+ * @param sourceLeft Capacity left at each vertex as a source.
+ * @param sinkLeft Capacity left at each vertex as a sink.
+ * @param src Set to the source where the path starts.
+ * @param dest Set to the sink where the path ends.
+ *
+ * @return True if a path from a source to a sink was found, false otherwise.
+ *
+ * @par Time Complexity
+ * O((V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph.
+ */
+bool Graph::findMinCostTerminalPath(const std::vector<int>& sourceLeft, const std::vector<int>& sinkLeft, Vertex*& src, Vertex*& dest){
+    PriorityQueue& q = searchHeap;
+    q.clear();
+    for (Vertex* v : vertexSet) {
+        v->setPath(nullptr);
+        v->setVisited(false);
+        v->setPathCost(sourceLeft[v->getId()] > 0 ? 0 : INF);
+        v->setLowerBound(0);
+        if (sourceLeft[v->getId()] > 0)
+            q.insert(v);
+    }
+
+    dest = nullptr;
+    while (!q.empty()){
+        Vertex* v = q.extractMin();
+        v->setVisited(true);
+        if (sinkLeft[v->getId()] > 0 && (dest == nullptr || v->getPathCost() < dest->getPathCost()))
+            dest = v;
+
+        for (Edge* e: v->getAdj()){
+            Vertex* w = e->getDest();
+            if (!w->isVisited() && e->getResidualCapacity() > 0){
+                int oldPathCost = w->getPathCost();
+                int newPathCost = v->getPathCost() + e->getCost();
+                if (newPathCost < oldPathCost){
+                    w->setPathCost(newPathCost);
+                    w->setPath(e);
+                    if(oldPathCost == INF)
+                        q.insert(w);
+                    else
+                        q.decreaseKey(w);
+                }
+            }
+        }
+    }
+
+    if (dest == nullptr)
+        return false;
+    for (src = dest; src->getPath() != nullptr; src = src->getPath()->getOrig());
+    return true;
+}
+
+/**
+ * @brief Augments the flow along the path found from a source to a sink, limited by what both can still take.
+ *
+ * @param sourceLeft Capacity left at each vertex as a source.
+ * @param sinkLeft Capacity left at each vertex as a sink.
+ * @param src The source where the path starts.
+ * @param dest The sink where the path ends.
+ *
+ * @return The flow sent along the path.
+ *
+ * @par Time complexity
+ * O(V), where V is the number of vertexes in the graph.
+ */
+int Graph::augmentTerminals(std::vector<int>& sourceLeft, std::vector<int>& sinkLeft, Vertex* src, Vertex* dest){
+    int f = std::min(std::min(sourceLeft[src->getId()], sinkLeft[dest->getId()]), findMinResidualAlongPath(src, dest));
+    augmentFlowAlongPath(src, dest, f);
+
+    if (sourceLeft[src->getId()] != INF) sourceLeft[src->getId()] -= f;
+    if (sinkLeft[dest->getId()] != INF) sinkLeft[dest->getId()] -= f;
+    terminalFlow[src->getId()] += f;
+    terminalFlow[dest->getId()] -= f;
+    return f;
+}
+
+/**
+ * @brief Checks if the residual capacities still hold the flow left by the last multi-terminal flow.
+ *
+ * Other algorithms (and other indexes that share the edges of the graph) may have changed the residual capacities
+ * since then, so every edge must carry a flow within its capacity and every vertex must send out exactly what it
+ * sent as a terminal (nothing, if it was not one).\n\n
+ *
+ * @return True if the flow can be used to warm start the next query, false otherwise.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+bool Graph::isWarmFlowValid() const {
+    if (terminalFlow.size() != vertexSet.size())
+        return false;
+
+    for (Vertex* v : vertexSet) {
+        int out = 0;
+        for (Edge* e : v->getAdj()) {
+            Edge* r = e->getReverse();
+            if (r == nullptr || e->getResidualCapacity() < 0 ||
+                e->getResidualCapacity() + r->getResidualCapacity() != e->getCapacity() + r->getCapacity())
+                return false;
+            out += e->getCapacity() - e->getResidualCapacity();
+        }
+        if (out != terminalFlow[v->getId()])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds a path in the residual graph between a vertex and the nearest vertex that satisfies a condition.
+ *
+ * The forward search follows the edges with residual capacity leaving each vertex and stores the path like
+ * findAugmentingPath. The backward search follows them in the opposite direction (looking for a vertex that can send
+ * flow to the start) and then stores the path from the vertex found to the start in the same way, so both can be
+ * walked with findMinResidualAlongPath and augmentFlowAlongPath.\n\n
+ *
+ * @param from The vertex where the search starts.
+ * @param forward True to search the vertexes that can receive flow from the start, false for the ones that can send.
+ * @param stop Condition on the vertex identifier that ends the search.
+ *
+ * @return The vertex found, or nullptr if there is none.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+Vertex* Graph::findRepairPath(Vertex* from, bool forward, const std::function<bool(int)>& stop){
+    for (Vertex* v : vertexSet)
+        v->setVisited(false);
+    from->setVisited(true);
+
+    searchQueue.clear();
+    searchQueue.push_back(from);
+    Vertex* found = nullptr;
+
+    for (size_t head = 0; head < searchQueue.size() && found == nullptr; head++){
+        Vertex* v = searchQueue[head];
+
+        for (Edge* e : v->getAdj()) {
+            Vertex* w = e->getDest();
+            Edge* step = forward ? e : e->getReverse();
+            if (w->isVisited() || step->getResidualCapacity() <= 0) continue;
+
+            w->setVisited(true);
+            exploredVertices++;
+            if (forward) w->setPath(e);
+            else w->setNext(step);
+            if (stop(w->getId())) {
+                found = w;
+                break;
+            }
+            searchQueue.push_back(w);
+        }
+    }
+
+    if (found != nullptr && !forward)
+        for (Vertex* v = found; v != from; v = v->getNext()->getDest())
+            v->getNext()->getDest()->setPath(v->getNext());
+    return found;
+}
+
+/**
+ * @brief Turns the flow of the last multi-terminal query into a valid flow for new terminals.
+ *
+ * A vertex that received more flow than it can now take (because it is no longer a sink, or has less capacity) has
+ * an excess, which is sent to the nearest vertex that can take it: a sink with capacity left, a vertex that sent too
+ * much, or back to a source. A vertex that sent more than it can now send has a deficit, which is covered by the
+ * nearest vertex that can give flow: a source with capacity left or a sink, which gives part of what it received.
+ * The flow elsewhere is kept, and the capacity left at each terminal is updated.\n\n
+ *
+ * @param sourceLeft Capacity of each vertex as a new source, updated to what is left.
+ * @param sinkLeft Capacity of each vertex as a new sink, updated to what is left.
+ *
+ * @par Time complexity
+ * O(P * (V + E)), where P is the number of paths needed and V, E the vertexes and edges of the graph.
+ */
+void Graph::repairFlow(std::vector<int>& sourceLeft, std::vector<int>& sinkLeft){
+    std::vector<int>& net = terminalFlow;
+    std::vector<int> excess(vertexSet.size(), 0), deficit(vertexSet.size(), 0);
+
+    for (unsigned int v = 0; v < vertexSet.size(); v++) {
+        if (net[v] > 0 && sourceLeft[v] != INF) {
+            int kept = std::min(net[v], sourceLeft[v]);
+            sourceLeft[v] -= kept;
+            deficit[v] = net[v] - kept;
+        }
+        else if (net[v] < 0 && sinkLeft[v] != INF) {
+            int kept = std::min(-net[v], sinkLeft[v]);
+            sinkLeft[v] -= kept;
+            excess[v] = -net[v] - kept;
+        }
+    }
+
+    for (unsigned int v = 0; v < vertexSet.size(); v++)
+        while (excess[v] > 0) {
+            Vertex* w = findRepairPath(vertexSet[v], true, [&](int id) {
+                return deficit[id] > 0 || sinkLeft[id] > 0 || net[id] > 0;
+            });
+            if (w == nullptr) break;
+
+            int id = w->getId();
+            int room = deficit[id] > 0 ? deficit[id] : sinkLeft[id] > 0 ? sinkLeft[id] : net[id];
+            int f = std::min(std::min(excess[v], room), findMinResidualAlongPath(vertexSet[v], w));
+            augmentFlowAlongPath(vertexSet[v], w, f);
+
+            if (deficit[id] > 0) deficit[id] -= f;
+            else if (sinkLeft[id] > 0) { if (sinkLeft[id] != INF) sinkLeft[id] -= f; }
+            else if (sourceLeft[id] != INF) sourceLeft[id] += f;
+            excess[v] -= f;
+            net[v] += f;
+            net[id] -= f;
+        }
+
+    for (unsigned int u = 0; u < vertexSet.size(); u++)
+        while (deficit[u] > 0) {
+            Vertex* w = findRepairPath(vertexSet[u], false, [&](int id) {
+                return sourceLeft[id] > 0 || net[id] < 0;
+            });
+            if (w == nullptr) break;
+
+            int id = w->getId();
+            int room = sourceLeft[id] > 0 ? sourceLeft[id] : -net[id];
+            int f = std::min(std::min(deficit[u], room), findMinResidualAlongPath(w, vertexSet[u]));
+            augmentFlowAlongPath(w, vertexSet[u], f);
+
+            if (sourceLeft[id] > 0) { if (sourceLeft[id] != INF) sourceLeft[id] -= f; }
+            else if (sinkLeft[id] != INF) sinkLeft[id] += f;
+            deficit[u] -= f;
+            net[u] -= f;
+            net[id] += f;
+        }
+}
+
+/**
+ * @brief Finds the maximum flow from a set of sources to a set of sinks using the Edmonds-Karp algorithm.
+ *
+ * Works as if a super source were connected to every source and a super sink to every sink, with the capacity of
+ * each terminal on that connection, but neither the graph nor a copy of it is changed to add them. A station that is
+ * both a source and a sink is only used as a source, since a train never travels from a station to itself.
+ * With warmStart, the flow left by the previous multi-terminal query (if the residual graph still holds it) is
+ * repaired for the new terminals with repairFlow and augmented from there, instead of starting from no flow, which
+ * saves most of the work when consecutive queries share most of their terminals.\n\n
+ *
+ * @param sources Map of source vertex identifier to the flow it can send (INF for no limit).
+ * @param sinks Map of sink vertex identifier to the flow it can receive (INF for no limit).
+ * @param warmStart True to start from the flow of the previous query.
+ *
+ * @return The maximum flow from the sources to the sinks.
+ *
+ * @par Time complexity
+ * O(V * E²), where V is the number of vertexes and E the number of edges in the graph.
+ */
+int Graph::maxFlow(const std::unordered_map<int, int>& sources, const std::unordered_map<int, int>& sinks, bool warmStart){
+    std::vector<int> sourceLeft = terminalCapacities(sources), sinkLeft = terminalCapacities(sinks, sourceLeft);
+
+    if (warmStart && isWarmFlowValid())
+        repairFlow(sourceLeft, sinkLeft);
+    else {
+        for (Vertex* vertex : vertexSet)
+            for (Edge* edge : vertex->getAdj())
+                edge->setResidualCapacity(edge->getCapacity());
+        terminalFlow.assign(vertexSet.size(), 0);
+    }
+
+    Vertex *src, *dest;
+    while (findTerminalAugmentingPath(sourceLeft, sinkLeft, src, dest))
+        augmentTerminals(sourceLeft, sinkLeft, src, dest);
+
+    int flow = 0;
+    for (int received : terminalFlow)
+        if (received < 0) flow -= received;
+    return flow;
+}
+
+/**
+ * @brief Finds the minimum cost of the maximum flow from a set of sources to a set of sinks.
+ *
+ * Uses the successive shortest path algorithm like minCost(source, target), as if a super source were connected to
+ * every source and a super sink to every sink with no cost, without changing the graph.\n\n
+ *
+ * @param sources Map of source vertex identifier to the flow it can send (INF for no limit).
+ * @param sinks Map of sink vertex identifier to the flow it can receive (INF for no limit).
+ *
+ * @return The minimum total cost of the trains from the sources to the sinks (see flowCost), or 0 if there is no
+ * feasible flow.
+ *
+ * @par Time complexity
+ * O(V * E² * log(V)), where V is the number of vertexes and E the number of edges in the graph.
+ */
+int Graph::minCost(const std::unordered_map<int, int>& sources, const std::unordered_map<int, int>& sinks){
+    std::vector<int> sourceLeft = terminalCapacities(sources), sinkLeft = terminalCapacities(sinks, sourceLeft);
+
+    for (Vertex* vertex : vertexSet)
+        for (Edge* edge : vertex->getAdj())
+            edge->setResidualCapacity(edge->getCapacity());
+    terminalFlow.assign(vertexSet.size(), 0);
+
+    Vertex *src, *dest;
+    while (findMinCostTerminalPath(sourceLeft, sinkLeft, src, dest))
+        augmentTerminals(sourceLeft, sinkLeft, src, dest);
+
+    return flowCost();
+}
+
+/**
+ * Calculates the total cost of the flow left by the last max flow: every train pays the cost of the service of each
+ * segment it crosses, so each edge adds its flow times its cost.\n\n
+ *
+ * @return The total cost of the flow, or INF if it does not fit in an int (see CapacityTraits).
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+int Graph::flowCost() const {
+    int cost = 0;
+    for (Vertex* vertex : vertexSet)
+        for (Edge* edge : vertex->getAdj())
+            if (edge->getCapacity() > edge->getResidualCapacity())
+                cost = CapacityTraits<int>::add(cost, CapacityTraits<int>::multiply(
+                        edge->getCapacity() - edge->getResidualCapacity(), edge->getCost()));
+    return cost;
+}
+
+/**
+ * @brief Finds the minimum cut left by the last call to maxFlow from the source.
+ *
+ * This function runs a BFS from the source over the edges that still have residual capacity, like
+ * findAugmentingPath, without computing any flow again. The edges that go from a reached vertex to one that was not
+ * reached are saturated, and together they separate the source from the target: their capacities add up to the max
+ * flow. It must be called right after maxFlow(source, target), before the residual capacities are changed by another
+ * algorithm.\n\n
+ *
+ * @param source The identifier of the source vertex used in maxFlow.
+ *
+ * @return The edges of the minimum cut, oriented from the source side to the target side.
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph.
+ */
+std::vector<Edge *> Graph::minCut(int source){
+    std::vector<Edge *> cut;
+    Vertex* src = findVertex(source);
+    if (src == nullptr)
+        return cut;
+
+    for (Vertex* v : vertexSet)
+        v->setVisited(false);
+    src->setVisited(true);
+
+    std::queue<Vertex*> queue;
+    queue.push(src);
+    while (!queue.empty()){
+        Vertex* v = queue.front();
+        queue.pop();
+
+        for (Edge* e : v->getAdj()) {
+            Vertex* w = e->getDest();
+            if (!w->isVisited() && e->getResidualCapacity() > 0) {
+                w->setVisited(true);
+                queue.push(w);
+            }
+        }
+    }
+
+    for (Vertex* v : vertexSet) {
+        if (!v->isVisited()) continue;
+        for (Edge* e : v->getAdj())
+            if (!e->getDest()->isVisited() && e->getCapacity() > 0)
+                cut.push_back(e);
+    }
+    return cut;
+}
+
+/**
+ * @brief Decomposes the flow left by the last call to maxFlow or minCost into the routes followed by the trains.
+ *
+ * This function reads the flow of each edge from the final residual graph (capacity minus residual capacity, which
+ * is positive in only one direction of each segment) and repeatedly walks from the source to the target along edges
+ * that still carry flow, taking the bottleneck of the walk as the number of trains of that route and removing it.
+ * Cycles found during a walk carry no trains from the source to the target, so their flow is cancelled. Each
+ * vertex remembers the next edge to try, so every edge is skipped at most once.\n\n
+ *
+ * @param source The identifier of the source vertex used in the flow algorithm.
+ * @param target The identifier of the target vertex used in the flow algorithm.
+ * @param expand Optional function that gives the stations crossed by an edge, from its origin to its destination,
+ * for graphs whose edges stand for several segments (see ChainContraction::routes); without it, the routes are made
+ * of the identifiers of the vertexes.
+ *
+ * @return The routes: stations from the source to the target, number of trains and cost of one train.
+ *
+ * @par Time complexity
+ * O(E * P), where E is the number of edges in the graph and P the number of routes.
+ */
+std::vector<Route> Graph::flowRoutes(int source, int target, const std::function<std::vector<int>(const Edge *)>& expand){
+    std::vector<Route> routes;
+    Vertex* src = findVertex(source);
+    Vertex* dest = findVertex(target);
+    if (src == nullptr || dest == nullptr || src == dest)
+        return routes;
+
+    std::unordered_map<Edge*, int> flow;
+    std::unordered_map<Vertex*, std::vector<Edge*>> out;
+    std::unordered_map<Vertex*, unsigned int> next;
+    for (Vertex* v : vertexSet)
+        for (Edge* e : v->getAdj())
+            if (e->getCapacity() - e->getResidualCapacity() > 0) {
+                flow[e] = e->getCapacity() - e->getResidualCapacity();
+                out[v].push_back(e);
+            }
+
+    std::vector<Edge*> path;
+    std::unordered_map<Vertex*, unsigned int> position = {{src, 0}};
+    Vertex* v = src;
+    while (true) {
+        if (v == dest) {
+            int trains = INF;
+            for (Edge* e : path)
+                trains = std::min(trains, flow[e]);
+
+            Route route = {{source}, trains, 0};
+            if (expand) route.stations.clear();
+            for (Edge* e : path) {
+                flow[e] -= trains;
+                if (expand) {
+                    std::vector<int> stations = expand(e);
+                    route.stations.insert(route.stations.end(), stations.begin() + (route.stations.empty() ? 0 : 1), stations.end());
+                }
+                else route.stations.push_back(e->getDest()->getId());
+                route.cost = CapacityTraits<int>::add(route.cost, e->getCost());
+            }
+            routes.push_back(route);
+
+            path.clear();
+            position = {{src, 0}};
+            v = src;
+            continue;
+        }
+
+        Edge* e = nullptr;
+        for (unsigned int& i = next[v]; i < out[v].size(); i++)
+            if (flow[out[v][i]] > 0) {
+                e = out[v][i];
+                break;
+            }
+        if (e == nullptr) {
+            if (v == src) break;
+            Edge* back = path.back();
+            flow[back] = 0;
+            path.pop_back();
+            position.erase(v);
+            v = back->getOrig();
+            continue;
+        }
+
+        Vertex* w = e->getDest();
+        auto cycle = position.find(w);
+        if (cycle == position.end()) {
+            path.push_back(e);
+            position[w] = path.size();
+            v = w;
+            continue;
+        }
+
+        int cancel = flow[e];
+        for (unsigned int i = cycle->second; i < path.size(); i++)
+            cancel = std::min(cancel, flow[path[i]]);
+        flow[e] -= cancel;
+        for (unsigned int i = cycle->second; i < path.size(); i++)
+            flow[path[i]] -= cancel;
+        while (path.size() > cycle->second) {
+            position.erase(path.back()->getDest());
+            path.pop_back();
+        }
+        v = w;
+    }
+
+    return routes;
+}
+
 /**
  * @brief Finds the minimum cost augmenting path from the source vertex to the destination vertex.
  *
  * This function uses Dijkstra's algorithm with a priority queue to find the minimum cost augmenting
- * path from the source vertex to the destination vertex in the graph. The function updates the path
- * information for each visited vertex and returns a boolean indicating whether a path was found or not.\n\n
+ * path from the source vertex to the destination vertex in the graph, and stops as soon as the destination is
+ * settled, since its path can no longer change. The search is not goal-directed by the landmarks: the total cost of
+ * the successive shortest paths depends on which of the paths with the same cost is taken, and a different order
+ * of the search would change it. The function updates the path information for each visited vertex and returns a
+ * boolean indicating whether a path was found or not.\n\n
  *
  * @param src A pointer to the source vertex.
  * @param dest A pointer to the destination vertex.
@@ -175,16 +913,21 @@ bool Graph::findMinCostAugmentingPath(Vertex* src, Vertex* dest){
         v->setPathCost(INF);
         v->setPath(nullptr);
         v->setVisited(false);
+        v->setLowerBound(0);
     }
 
     src->setPathCost(0);
 
-    PriorityQueue q;
+    PriorityQueue& q = searchHeap;
+    q.clear();
     q.insert(src);
 
     while(!q.empty()){
         Vertex* v = q.extractMin();
         v->setVisited(true);
+        exploredVertices++;
+        if (v == dest)
+            break;
         for (Edge* e: v->getAdj()){
             Vertex* w = e->getDest();
             int residual = e->getResidualCapacity();
@@ -212,7 +955,8 @@ bool Graph::findMinCostAugmentingPath(Vertex* src, Vertex* dest){
  * @param source The identifier of the source vertex.
  * @param target The identifier of the target vertex.
  *
- * @return The minimum cost of the flow from the source to the target, or 0 if there is no feasible flow.
+ * @return The minimum total cost of the trains from the source to the target (see flowCost), or 0 if there is no
+ * feasible flow.
  *
  * @par Time complexity
  * O(V * E² * log(V)), where V is the number of vertexes and E the number of edges in the graph.
@@ -224,19 +968,17 @@ int Graph::minCost(int source, int target) {
     if (src == nullptr || dest == nullptr || src == dest)
         return 0;
 
-    int cost = 0;
-
     for (Vertex* vertex : vertexSet)
         for (Edge* edge : vertex->getAdj())
             edge->setResidualCapacity(edge->getCapacity());
+    terminalFlow.clear();
 
     while (findMinCostAugmentingPath(src,dest)) {
         auto f = findMinResidualAlongPath(src, dest);
         augmentFlowAlongPath(src, dest, f);
-        cost += dest->getPathCost();
     }
 
-    return cost;
+    return flowCost();
 }
 
 /**
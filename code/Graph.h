@@ -4,32 +4,80 @@
 #include <algorithm>
 #include <stack>
 #include <list>
+#include <unordered_map>
+#include <functional>
 
 #include "VertexEdge.h"
 #include "PriorityQueue.h"
+#include "Landmarks.h"
+#include "Capacity.h"
+
+struct Route {
+    std::vector<int> stations;
+    int trains;
+    int cost;
+};
 
 class Graph {
 public:
 
     Vertex *findVertex(const int &id) const;
     void addVertex(const int &id,Station station);
-    void addEdge(const int &source, const int &dest, int capacity, const std::string& service) const;
+    Edge *addEdge(const int &source, const int &dest, int capacity, Service service, int duration = 1);
+    Edge *findEdge(int source, int dest, unsigned int parallel = 0) const;
+    unsigned int segmentCount(int source, int dest) const;
+    void setSegmentCapacity(Edge *edge, int capacity);
+    void removeSegment(Edge *edge);
 
-    std::vector<Vertex *> getVertexSet() const;
+    const std::vector<Vertex *>& getVertexSet() const;
+    const Landmarks& getLandmarks() const;
+
+    void buildLandmarks(unsigned int count = LANDMARKS);
 
     int minCost(int source, int target);
-    int maxFlow(int source, int target);
+    int maxFlow(int source, int target, bool bidirectional = false);
+
+    int maxFlow(const std::unordered_map<int, int>& sources, const std::unordered_map<int, int>& sinks, bool warmStart = false);
+    int minCost(const std::unordered_map<int, int>& sources, const std::unordered_map<int, int>& sinks);
+    std::vector<Edge *> minCut(int source);
+    std::vector<Route> flowRoutes(int source, int target, const std::function<std::vector<int>(const Edge *)>& expand = nullptr);
+
+    unsigned long getExploredVertices() const;
 
     unsigned int maxConnectedDistrict(const std::string& district);
     unsigned int maxConnectedMunicipality(const std::string& municipality);
 
 private:
     std::vector<Vertex *> vertexSet;
+    unsigned long exploredVertices = 0;
+    std::vector<int> terminalFlow;
+    std::vector<Vertex *> searchQueue;
+    std::vector<Vertex *> backwardQueue;
+    PriorityQueue searchHeap;
+    Landmarks landmarks;
 
     bool findAugmentingPath(Vertex *src, Vertex *dest);
 
+    bool findBidirectionalAugmentingPath(Vertex *src, Vertex *dest);
+
     bool findMinCostAugmentingPath(Vertex* src, Vertex* dest);
 
+    bool findTerminalAugmentingPath(const std::vector<int>& sourceLeft, const std::vector<int>& sinkLeft, Vertex*& src, Vertex*& dest);
+
+    bool findMinCostTerminalPath(const std::vector<int>& sourceLeft, const std::vector<int>& sinkLeft, Vertex*& src, Vertex*& dest);
+
+    std::vector<int> terminalCapacities(const std::unordered_map<int, int>& terminals, const std::vector<int>& exclude = {}) const;
+
+    int augmentTerminals(std::vector<int>& sourceLeft, std::vector<int>& sinkLeft, Vertex* src, Vertex* dest);
+
+    bool isWarmFlowValid() const;
+
+    Vertex* findRepairPath(Vertex* from, bool forward, const std::function<bool(int)>& stop);
+
+    void repairFlow(std::vector<int>& sourceLeft, std::vector<int>& sinkLeft);
+
+    int flowCost() const;
+
     static int findMinResidualAlongPath(Vertex *src, Vertex *dest);
 
     static void augmentFlowAlongPath(Vertex *src, Vertex *dest, int flow);
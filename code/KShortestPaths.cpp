@@ -0,0 +1,184 @@
+#include "KShortestPaths.h"
+
+/**
+ * Prepares the search of the cheapest routes of a graph. The workspace of Dijkstra's algorithm (priority queue,
+ * blocked stations and banned segments) is kept between searches, so the spur paths do not allocate it again, and
+ * the landmarks of the graph (if built) guide every search towards the target.\n\n
+ *
+ * @param graph The graph, whose vertexes store the state of each search.
+ *
+ * @par Time complexity
+ * O(V), where V is the number of vertexes in the graph.
+ */
+KShortestPaths::KShortestPaths(const Graph& graph): vertexSet(graph.getVertexSet()), landmarks(graph.getLandmarks()),
+    blocked(vertexSet.size(), 0) {}
+
+/**
+ * @return The number of vertexes settled by the searches so far.
+ */
+unsigned long KShortestPaths::getExploredVertices() const {
+    return exploredVertices;
+}
+
+/**
+ * Checks if a segment may not be used by the current spur path.\n\n
+ *
+ * @param edge The edge (one direction of the segment).
+ *
+ * @return True if the edge is banned, false otherwise.
+ *
+ * @par Time complexity
+ * O(b), where b is the number of banned edges (at most the number of routes found).
+ */
+bool KShortestPaths::isBanned(const Edge* edge) const {
+    return std::find(banned.begin(), banned.end(), edge) != banned.end();
+}
+
+/**
+ * Finds the cheapest path between two stations with Dijkstra's algorithm, by the cost of the service of each
+ * segment, avoiding the blocked stations and the banned segments. The search is goal-directed by the lower bounds of
+ * the landmarks (A*) and stops when the target is settled. The path is stored in spur.\n\n
+ *
+ * @param src A pointer to the source vertex.
+ * @param dest A pointer to the target vertex.
+ *
+ * @return True if there is a path, false otherwise.
+ *
+ * @par Time complexity
+ * O((V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph.
+ */
+bool KShortestPaths::cheapestPath(Vertex* src, Vertex* dest) {
+    for (Vertex* v : vertexSet) {
+        v->setPathCost(INF);
+        v->setPath(nullptr);
+        v->setVisited(false);
+    }
+
+    spur.clear();
+    int bound = landmarks.lowerBound(src->getId(), dest->getId());
+    if (bound == INF)
+        return false;
+    src->setPathCost(0);
+    src->setLowerBound(bound);
+    queue.clear();
+    queue.insert(src);
+
+    while (!queue.empty()) {
+        Vertex* v = queue.extractMin();
+        exploredVertices++;
+        if (v == dest) break;
+        v->setVisited(true);
+        for (Edge* e : v->getAdj()) {
+            Vertex* w = e->getDest();
+            if (w->isVisited() || blocked[w->getId()] || isBanned(e)) continue;
+            int oldPathCost = w->getPathCost();
+            int newPathCost = v->getPathCost() + e->getCost();
+            if (newPathCost < oldPathCost) {
+                if (oldPathCost == INF) {
+                    bound = landmarks.lowerBound(w->getId(), dest->getId());
+                    if (bound == INF) continue;
+                    w->setLowerBound(bound);
+                }
+                w->setPathCost(newPathCost);
+                w->setPath(e);
+                if (oldPathCost == INF)
+                    queue.insert(w);
+                else
+                    queue.decreaseKey(w);
+            }
+        }
+    }
+
+    if (dest->getPathCost() == INF)
+        return false;
+    for (Vertex* v = dest; v != src; v = v->getPath()->getOrig())
+        spur.push_back(v->getPath());
+    std::reverse(spur.begin(), spur.end());
+    return true;
+}
+
+/**
+ * @param path A path.
+ *
+ * @return The route of the path: its stations, the number of trains it can take (the smallest capacity of its
+ * segments) and the cost of one train.
+ */
+Route KShortestPaths::toRoute(const Path& path) {
+    Route route = {{path.edges.front()->getOrig()->getId()}, INF, path.cost};
+    for (Edge* e : path.edges) {
+        route.stations.push_back(e->getDest()->getId());
+        route.trains = std::min(route.trains, e->getCapacity());
+    }
+    return route;
+}
+
+/**
+ * Finds the k cheapest routes without repeated stations between two stations, with Yen's algorithm: each new route
+ * leaves the previous one at some station (the spur) and takes the cheapest way from there to the target that
+ * avoids the stations before the spur and the segments already taken from it by the routes with the same beginning.
+ * Routes with the same cost are ordered by number of segments.\n\n
+ *
+ * @param source The identifier of the source vertex.
+ * @param target The identifier of the target vertex.
+ * @param k The number of routes wanted.
+ *
+ * @return The routes, cheapest first (fewer than k if there are no more).
+ *
+ * @par Time complexity
+ * O(k * V * (V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph.
+ */
+std::vector<Route> KShortestPaths::find(int source, int target, unsigned int k) {
+    std::vector<Route> routes;
+    int n = (int) vertexSet.size();
+    if (k == 0 || source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return routes;
+
+    Vertex* src = vertexSet[source];
+    Vertex* dest = vertexSet[target];
+    banned.clear();
+    if (!cheapestPath(src, dest))
+        return routes;
+
+    std::vector<Path> found = {{spur, dest->getPathCost()}};
+    std::vector<Path> candidates;
+    auto cheaper = [](const Path& a, const Path& b) {
+        return a.cost != b.cost ? a.cost < b.cost : a.edges.size() < b.edges.size();
+    };
+
+    while (found.size() < k) {
+        const std::vector<Edge*> last = found.back().edges;
+        int rootCost = 0;
+        for (unsigned int i = 0; i < last.size(); i++) {
+            Vertex* spurVertex = last[i]->getOrig();
+
+            banned.clear();
+            for (const Path& path : found)
+                if (path.edges.size() > i && std::equal(last.begin(), last.begin() + i, path.edges.begin()))
+                    banned.push_back(path.edges[i]);
+            for (unsigned int j = 0; j < i; j++)
+                blocked[last[j]->getOrig()->getId()] = 1;
+
+            if (cheapestPath(spurVertex, dest)) {
+                Path path = {std::vector<Edge*>(last.begin(), last.begin() + i), rootCost + dest->getPathCost()};
+                path.edges.insert(path.edges.end(), spur.begin(), spur.end());
+                auto same = [&path](const Path& other) { return other.edges == path.edges; };
+                if (std::none_of(candidates.begin(), candidates.end(), same) && std::none_of(found.begin(), found.end(), same))
+                    candidates.push_back(std::move(path));
+            }
+
+            for (unsigned int j = 0; j < i; j++)
+                blocked[last[j]->getOrig()->getId()] = 0;
+            rootCost += last[i]->getCost();
+        }
+
+        if (candidates.empty())
+            break;
+        auto best = std::min_element(candidates.begin(), candidates.end(), cheaper);
+        found.push_back(std::move(*best));
+        candidates.erase(best);
+    }
+
+    for (const Path& path : found)
+        routes.push_back(toRoute(path));
+    return routes;
+}
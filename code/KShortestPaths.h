@@ -0,0 +1,35 @@
+#ifndef DA_KSHORTESTPATHS_H
+#define DA_KSHORTESTPATHS_H
+
+#include <vector>
+
+#include "Graph.h"
+
+class KShortestPaths {
+public:
+    explicit KShortestPaths(const Graph& graph);
+
+    std::vector<Route> find(int source, int target, unsigned int k);
+    unsigned long getExploredVertices() const;
+
+private:
+    struct Path {
+        std::vector<Edge*> edges;
+        int cost;
+    };
+
+    std::vector<Vertex*> vertexSet;
+    const Landmarks& landmarks;
+
+    PriorityQueue queue;
+    std::vector<char> blocked;
+    std::vector<Edge*> banned;
+    std::vector<Edge*> spur;
+    unsigned long exploredVertices = 0;
+
+    bool cheapestPath(Vertex* src, Vertex* dest);
+    bool isBanned(const Edge* edge) const;
+    static Route toRoute(const Path& path);
+};
+
+#endif //DA_KSHORTESTPATHS_H
@@ -0,0 +1,112 @@
+#include "Landmarks.h"
+
+#include <functional>
+#include <cstdlib>
+
+Landmarks::Landmarks() = default;
+
+/**
+ * Chooses landmark stations and stores the cost from each of them to every station, for the lower bounds of the
+ * goal-directed searches (ALT: A*, landmarks and the triangle inequality). The landmarks are chosen by farthest
+ * point: the first is the station farthest from the first station with segments, and each of the others the one
+ * whose cost to its closest landmark is the largest, so they end up on the edges of the network. A station that no
+ * landmark reaches goes first, so every connected component gets a landmark.\n\n
+ *
+ * The bounds only hold while no segment is added and no cost is lowered: removing segments or changing capacities
+ * keeps them valid.\n\n
+ *
+ * @param vertexSet The vertexes of the graph.
+ * @param count The number of landmarks wanted.
+ *
+ * @par Time complexity
+ * O(L * (V + E) * log(V)), where L is the number of landmarks, V the number of vertexes and E the number of edges
+ */
+Landmarks::Landmarks(const std::vector<Vertex *>& vertexSet, unsigned int count) : n((int) vertexSet.size()) {
+    std::vector<int> dist, closest(n, INF);
+    std::vector<std::vector<int>> found;
+
+    int landmark = -1;
+    for (int v = 0; v < n && landmark == -1; v++)
+        if (!vertexSet[v]->getAdj().empty()) landmark = v;
+    if (landmark != -1) {
+        costs(vertexSet, landmark, dist);
+        for (int v = 0; v < n; v++)
+            if (dist[v] != INF && dist[v] > dist[landmark]) landmark = v;
+    }
+
+    while (landmark != -1 && found.size() < count) {
+        costs(vertexSet, landmark, dist);
+        found.push_back(dist);
+        for (int v = 0; v < n; v++)
+            closest[v] = std::min(closest[v], dist[v]);
+
+        landmark = -1;
+        for (int v = 0; v < n; v++)
+            if (!vertexSet[v]->getAdj().empty() && closest[v] > 0 && (landmark == -1 || closest[v] > closest[landmark]))
+                landmark = v;
+    }
+
+    this->count = (unsigned int) found.size();
+    distance.resize((size_t) n * this->count);
+    for (int v = 0; v < n; v++)
+        for (unsigned int l = 0; l < this->count; l++)
+            distance[(size_t) v * this->count + l] = found[l][v];
+}
+
+/**
+ * Lower bound of the cost from a station to the target: by the triangle inequality, the cost between them is at
+ * least the difference of their costs to any landmark (the segments have the same cost in both directions).\n\n
+ *
+ * @param id The station.
+ * @param target The target station.
+ *
+ * @return The largest difference over the landmarks, INF if a landmark reaches only one of them (they are not
+ * connected), 0 for stations added after the landmarks.
+ *
+ * @par Time complexity
+ * O(L), where L is the number of landmarks
+ */
+int Landmarks::lowerBound(int id, int target) const {
+    if (id >= n || target >= n) return 0;
+    const int* a = &distance[(size_t) id * count];
+    const int* b = &distance[(size_t) target * count];
+    int bound = 0;
+    for (unsigned int l = 0; l < count; l++) {
+        if (a[l] == INF || b[l] == INF) {
+            if (a[l] != b[l]) return INF;
+            continue;
+        }
+        bound = std::max(bound, std::abs(a[l] - b[l]));
+    }
+    return bound;
+}
+
+/**
+ * Dijkstra's algorithm from a landmark, by the cost of every segment (whatever its capacity), without changing the
+ * state of the vertexes.\n\n
+ *
+ * @param vertexSet The vertexes of the graph.
+ * @param source The landmark.
+ * @param dist Vector where the cost to each vertex is stored (INF if not reached).
+ *
+ * @par Time complexity
+ * O((V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph
+ */
+void Landmarks::costs(const std::vector<Vertex *>& vertexSet, int source, std::vector<int>& dist) {
+    dist.assign(vertexSet.size(), INF);
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> queue;
+    dist[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty()) {
+        auto top = queue.top();
+        queue.pop();
+        if (top.first > dist[top.second]) continue;
+        for (Edge* e : vertexSet[top.second]->getAdj()) {
+            int w = e->getDest()->getId();
+            if (top.first + e->getCost() < dist[w]) {
+                dist[w] = top.first + e->getCost();
+                queue.emplace(dist[w], w);
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef DA_LANDMARKS_H
+#define DA_LANDMARKS_H
+
+#include <vector>
+
+#include "VertexEdge.h"
+
+#define LANDMARKS 8
+
+class Landmarks {
+public:
+    Landmarks();
+    Landmarks(const std::vector<Vertex *>& vertexSet, unsigned int count);
+
+    int lowerBound(int id, int target) const;
+
+private:
+    int n = 0;
+    unsigned int count = 0;
+    std::vector<int> distance;
+
+    static void costs(const std::vector<Vertex *>& vertexSet, int source, std::vector<int>& dist);
+};
+
+#endif //DA_LANDMARKS_H
@@ -61,8 +61,10 @@ void Menu::init() {
  * Allows the user to choose what details of basic services they want to know:
  *      the maximum number of trains that can simultaneously travel between two specific stations,
  *      which pairs of stations require the most amount of trains,
- *      where management should assign larger budgets for the purchasing and maintenance of trains or
- *      the maximum number of trains that can simultaneously arrive at a given station.\n\n
+ *      where management should assign larger budgets for the purchasing and maintenance of trains,
+ *      the maximum number of trains that can simultaneously arrive at a given station,
+ *      the maximum number of trains that can travel between two stations within a time horizon or
+ *      the cheapest alternative routes between two stations.\n\n
  */
 void Menu::basicService(){
     std::string option;
@@ -71,7 +73,9 @@ void Menu::basicService(){
                 " [1] Maximum number of trains that can simultaneously travel between two specific stations\n"
                 " [2] Which pairs of stations require the most amount of trains\n"
                 " [3] Top-k municipalities or districts\n"
-                " [4] Maximum number of trains that can simultaneously arrive at a given station\n\n"
+                " [4] Maximum number of trains that can simultaneously arrive at a given station\n"
+                " [5] Maximum number of trains between two specific stations within a time horizon\n"
+                " [6] Cheapest alternative routes between two specific stations\n\n"
                 " Option: ";
 
         std::cin >> option;
@@ -98,6 +102,20 @@ void Menu::basicService(){
             maxStationFlow(station);
             return;
         }
+        else if (option == "5"){
+            std::cin.ignore();
+            std::string source, target;
+            if (validatePath(source,target) == "0") continue;
+            timedFlow(source, target);
+            return;
+        }
+        else if (option == "6"){
+            std::cin.ignore();
+            std::string source, target;
+            if (validatePath(source,target) == "0") continue;
+            cheapestRoutes(false, source, target);
+            return;
+        }
         else if (option == "0"){
             std::cout << "\n";
             return;
@@ -119,19 +137,20 @@ void Menu::basicService(){
 void Menu::maxFlow(bool subgraph, const std::string& srcStation, const std::string& destStation) {
 
     int src, dest, maxFlow;
-    Graph graph = subgraph ? supervisor->getSubGraph() : supervisor->getGraph();
-    std::unordered_map<std::string,int> idStations = subgraph ? supervisor->getSubGraphStations() : supervisor->getId();
+    const std::unordered_map<std::string,int>& idStations = supervisor->getId();
 
     if (idStations.count(srcStation) && idStations.count(destStation)) {
-        src = idStations[srcStation];
-        dest = idStations[destStation];
-        maxFlow = graph.maxFlow(src,dest);
+        src = idStations.at(srcStation);
+        dest = idStations.at(destStation);
+        maxFlow = supervisor->pairMaxFlow(subgraph, src, dest);
     } else
         maxFlow = 0;
-    if (maxFlow != 0)
+    if (maxFlow != 0) {
         std::cout << "\n Maximum number of trains between " << "\033[1m\033[36m" << srcStation << "\033[0m"
         << " and " << "\033[1m\033[36m" << destStation << "\033[0m" << ": "
-        << "\033[1m\033[42m" << " " << maxFlow * 2 << " " << "\033[0m" << "\n\n";
+        << "\033[1m\033[42m" << " " << maxFlow << " " << "\033[0m" << "\n";
+        showBottleneck(supervisor->bottleneck(subgraph, src, dest));
+    }
     else
         std::cout << "\n There is no path between " << "\033[1m\033[36m" << srcStation << "\033[0m"
                   << " and " << "\033[1m\033[36m" << destStation << "\033[0m" << " :(\n\n";
@@ -139,71 +158,51 @@ void Menu::maxFlow(bool subgraph, const std::string& srcStation, const std::stri
 }
 
 /**
- * This functions calculates all the pairs of stations that require the most amount of trains when taking full advantage of the existing network capacity.\n\n
- *
- * @param start starting station
- * @param end ending station
- * @param graph original graph
- * @param maxFlow
- * @param spinLock
- * @param pairs
+ * Shows the saturated segments that limit the number of trains between two stations.\n\n
  *
- * @par Time complexity
- * O(V³ * E²), where V is the number of nodes and E is the number of edges
+ * @param cut edges of the minimum cut
  */
-void maxFlowWorker(int start, int end, Graph graph, std::atomic<int>& maxFlow, std::atomic_flag& spinLock, std::atomic<std::list<std::pair<int,int>>*>& pairs) {
-    int localMax = 0;
-    std::list<std::pair<int,int>> localPairs;
-    for (int i = start; i < end; i++)
-        for (int j = i + 1; j < graph.getVertexSet().size(); j++) {
-            int flow = graph.maxFlow(i, j);
-            if (flow > localMax) {
-                localMax = flow;
-                localPairs.clear();
-                localPairs.emplace_back(i, j);
-            } else if (flow == localMax)
-                localPairs.emplace_back(i, j);
-        }
-
-    while (spinLock.test_and_set(std::memory_order_acquire));
-    if (localMax > maxFlow) {
-        maxFlow = localMax;
-        *pairs = localPairs;
-    } else if (localMax == maxFlow)
-        (*pairs).insert((*pairs).end(), localPairs.begin(), localPairs.end());
-    spinLock.clear(std::memory_order_release);
+void Menu::showBottleneck(const std::vector<Edge *>& cut){
+    std::cout << "\n Bottleneck segments:\n";
+    for (Edge* e : cut)
+        std::cout << "\n \033[1m\033[36m" << e->getOrig()->getStation().getName() << "\033[0m - "
+                  << "\033[1m\033[36m" << e->getDest()->getStation().getName() << "\033[0m ("
+                  << serviceInfo(e->getService()).name << ") | Capacity: " << "\033[1m\033[35m" << e->getCapacity() << "\033[0m";
+    std::cout << "\n\n";
 }
 
 /**
- * This function calculates the station pairs that require the highest number of trains and distributes the workload across threads,
- * resulting in faster execution of the maxFlowWorker function.\n\n
+ * Shows the routes followed by the trains between two stations.\n\n
+ *
+ * @param subgraph true for a subGraph(line/station/segment failure)
+ * @param routes routes of the flow
  */
-void Menu::mostAmountOfTrains() {
-
-    std::atomic<std::list<std::pair<int, int>> *> pairs(new std::list<std::pair<int, int>>());
-    std::atomic<int> maxFlow(0);
-    std::atomic_flag spinLock = ATOMIC_FLAG_INIT;
-    std::vector<std::thread> workers;
-
-    int num_vertices = supervisor->getGraph().getVertexSet().size();
-    int num_threads = 32;
-    int chunk_size = num_vertices / num_threads;
-
-    for (int i = 0; i < num_threads; i++) {
-        int start = i * chunk_size;
-        int end = (i + 1) * chunk_size;
-        workers.emplace_back(maxFlowWorker, start, end, supervisor->originalGraph(), std::ref(maxFlow), std::ref(spinLock), std::ref(pairs));
+void Menu::showRoutes(bool subgraph, const std::vector<Route>& routes){
+    const Graph& graph = subgraph ? supervisor->getSubGraph() : supervisor->getGraph();
+    std::cout << "\n Routes:\n";
+    for (const Route& route : routes) {
+        std::cout << "\n \033[1m\033[35m" << route.trains << "\033[0m trains, "
+                  << "\033[1m\033[36m" << route.cost << "\033[0m € each:";
+        for (unsigned int i = 0; i < route.stations.size(); i++)
+            std::cout << (i ? " -> " : " ") << graph.findVertex(route.stations[i])->getStation().getName();
     }
+    std::cout << "\n\n";
+}
 
-    for (auto &worker: workers)
-        worker.join();
+/**
+ * This function calculates the station pairs that require the highest number of trains. If the flow matrix was built
+ * for the current network the pairs are read from it, otherwise from the flow-equivalent tree of the network.\n\n
+ */
+void Menu::mostAmountOfTrains() {
+    std::vector<std::pair<int, int>> pairs;
+    int maxFlow = supervisor->busiestPairs(pairs);
 
     std::cout << "\n The maximum possible flow between two stations: "
-                 "\033[1m\033[36m" << maxFlow * 2 << "\033[0m \n\n";
+                 "\033[1m\033[36m" << maxFlow << "\033[0m \n\n";
 
     std::string srcStation, targetStation;
 
-    for (const auto &pair: *pairs) {
+    for (const auto &pair: pairs) {
         std::cout << "\033[1m\033[31m • \033[0m";
         srcStation = supervisor->getGraph().findVertex(pair.first)->getStation().getName();
         targetStation = supervisor->getGraph().findVertex(pair.second)->getStation().getName();
@@ -252,38 +251,55 @@ void Menu::transportNeeds(int type){
         std::cout << "\n What would you like to know?\n\n";
         if (type){
             std::cout << " [1] Transport needs inside a municipality\n"
-                " [2] Transport needs with other municipalities\n\n"
+                " [2] Transport needs with other municipalities\n"
+                " [3] Trains from one municipality to another\n\n"
                 " Option: ";
         }
         else {
             std::cout << " [1] Transport needs inside a district\n"
-                    " [2] Transport needs with other districts\n\n"
+                    " [2] Transport needs with other districts\n"
+                    " [3] Trains from one district to another\n\n"
                     " Option: ";
         }
         std::cin >> option;
         if (option == "1") {
-            auto result = supervisor->maxConnectedStations(type);
             int choice = showTop(), top;
             if (choice == 1) top = 10;
             else if (choice == 2) top = 15;
-            else if (choice == 3) top = customTop("\n Pick a custom top: ", result.size());
+            else if (choice == 3) top = customTop("\n Pick a custom top: ", supervisor->regionCount(type));
             else continue;
+            if (top == 0) continue;
 
-            for (int i = 0; i < top; i++)
+            auto result = supervisor->maxConnectedStations(type, top);
+            for (int i = 0; i < (int) result.size(); i++)
                 std::cout << "\n\033[1m\033[36m " << i+1 << ".\033[0m "<< result[i].first << " | Max nº of connected stations: "
                      << "\033[1m\033[32m" << result[i].second << "\033[0m \n";
 
         } else if (option == "2") {
-            auto result = supervisor->transportNeeds(true, supervisor->originalGraph(), type);
             int choice = showTop(), top;
             if (choice == 1) top = 10;
             else if (choice == 2) top = 15;
-            else if (choice == 3) top = customTop("\n Pick a custom top: ", result.size());
+            else if (choice == 3) top = customTop("\n Pick a custom top: ", supervisor->regionCount(type));
             else continue;
+            if (top == 0) continue;
 
-            for (int i = 0; i < top; i++)
+            auto result = supervisor->transportNeeds(type, top);
+            for (int i = 0; i < (int) result.size(); i++)
                 std::cout << "\n\033[1m\033[32m " << i+1 << ".\033[0m "<< result[i].first << " | Maximum flow: "
-                << "\033[1m\033[35m" << result[i].second * 2 << "\033[0m \n";
+                << "\033[1m\033[35m" << result[i].second << "\033[0m \n";
+
+        } else if (option == "3") {
+            std::cin.ignore();
+            std::string from = validateRegion("\n Insert the name of the origin (ex: FARO): ", type);
+            if (from == "0") continue;
+            std::string to = validateRegion(" Insert the name of the destination (ex: LISBOA): ", type);
+            if (to == "0") continue;
+
+            auto result = supervisor->regionFlow(from, to, type);
+            std::cout << "\n Maximum number of trains from " << "\033[1m\033[36m" << from << "\033[0m"
+                      << " to " << "\033[1m\033[36m" << to << "\033[0m" << ": "
+                      << "\033[1m\033[42m" << " " << result.first << " " << "\033[0m"
+                      << " | Minimum cost: " << "\033[1m\033[36m" << result.second << "\033[0m €\n";
 
         } else if (option == "0") {
             return;
@@ -308,32 +324,83 @@ void Menu::maxStationFlow(const std::string& station){
     << "\033[1m\033[35m" << maxFlow << "\033[0m \n" << "\n";
 }
 
+/**
+ * This function calculates the maximum number of trains that can travel between two specific stations within a
+ * horizon of time slots chosen by the user, using the duration of each segment, and their minimum total cost.\n\n
+ * @param srcStation user input for source station
+ * @param destStation user input for dest station
+ */
+void Menu::timedFlow(const std::string& srcStation, const std::string& destStation){
+    int slots = customTop("\n How many time slots does the horizon have (ex: 24): ", 1440);
+    if (slots == 0) return;
+
+    const std::unordered_map<std::string,int>& idStations = supervisor->getId();
+    std::pair<int, int> result = {0, 0};
+    if (idStations.count(srcStation) && idStations.count(destStation))
+        result = supervisor->timedFlow(idStations.at(srcStation), idStations.at(destStation), slots);
+    if (result.first != 0)
+        std::cout << "\n Maximum number of trains between " << "\033[1m\033[36m" << srcStation << "\033[0m"
+                  << " and " << "\033[1m\033[36m" << destStation << "\033[0m" << " in " << slots << " time slots: "
+                  << "\033[1m\033[42m" << " " << result.first << " " << "\033[0m"
+                  << " | Minimum total cost: " << "\033[1m\033[36m" << result.second << "\033[0m €\n\n";
+    else
+        std::cout << "\n " << "\033[1m\033[36m" << destStation << "\033[0m" << " cannot be reached from "
+                  << "\033[1m\033[36m" << srcStation << "\033[0m" << " in " << slots << " time slots :(\n\n";
+}
+
 /**
  * This function calculates the maximum amount of trains that can simultaneously travel between
- * two specific stations with minimum cost for the company.\n\n
+ * two specific stations with minimum cost for the company. The cost shown is the one of the routes listed, so both
+ * come from the same min cost flow.\n\n
  * @param subgraph type of graph used
  * @param srcStation user input for source station
  * @param destStation user input for dest station
  */
 void Menu::costOptimization(bool subgraph, const std::string& srcStation, const std::string& destStation){
 
-    int src, dest;
-    Graph graph = subgraph ? supervisor->getSubGraph() : supervisor->getGraph();
-    std::unordered_map<std::string,int> idStations = subgraph ? supervisor->getSubGraphStations() : supervisor->getId();
+    int cost = 0;
+    std::vector<Route> routes;
+    const std::unordered_map<std::string,int>& idStations = supervisor->getId();
 
-    src = idStations[srcStation];
-    dest = idStations[destStation];
+    if (idStations.count(srcStation) && idStations.count(destStation))
+        routes = supervisor->routes(subgraph, idStations.at(srcStation), idStations.at(destStation));
+    for (const Route& route : routes)
+        cost = CapacityTraits<int>::add(cost, CapacityTraits<int>::multiply(route.trains, route.cost));
 
-    int cost = graph.minCost(src,dest);
-    if (cost != 0)
+    if (!routes.empty()) {
         std::cout << "\n\033[1m\033[36m Minimum\033[0m cost for the \033[1m\033[34mmaximum\033[0m amount of trains between "
         "\033[1m\033[45m " << srcStation << " \033[0m and \033[1m\033[43m " << destStation << " \033[0m : "
-        << "\033[1m\033[36m" << cost * 2 << "\033[0m €\n\n";
+        << "\033[1m\033[36m" << cost << "\033[0m €\n";
+        showRoutes(subgraph, routes);
+    }
     else
         std::cout << "\n There is no path between " << "\033[1m\033[36m" << srcStation << "\033[0m"
           << " and " << "\033[1m\033[36m" << destStation << "\033[0m" << " :(\n\n";
 }
 
+/**
+ * Shows the k cheapest alternative routes between two stations, chosen by the user, with the number of trains each
+ * one can take, so the trains can be rerouted when a route is not available.\n\n
+ * @param subgraph type of graph used
+ * @param srcStation user input for source station
+ * @param destStation user input for dest station
+ */
+void Menu::cheapestRoutes(bool subgraph, const std::string& srcStation, const std::string& destStation){
+    int k = customTop("\n How many routes would you like to see (ex: 5): ", 50);
+    if (k == 0) return;
+
+    const std::unordered_map<std::string,int>& idStations = supervisor->getId();
+    std::vector<Route> routes;
+    if (idStations.count(srcStation) && idStations.count(destStation))
+        routes = supervisor->cheapestRoutes(subgraph, idStations.at(srcStation), idStations.at(destStation), k);
+
+    if (!routes.empty())
+        showRoutes(subgraph, routes);
+    else
+        std::cout << "\n There is no path between " << "\033[1m\033[36m" << srcStation << "\033[0m"
+                  << " and " << "\033[1m\033[36m" << destStation << "\033[0m" << " :(\n\n";
+}
+
 /**
  * Gives the user the option to choose what type of failure he wants to assess.\n\n
  */
@@ -343,7 +410,11 @@ void Menu::reliability(){
         std::cout << "\n What aspect of the railway network you would like to assess the sensitivity of to failures?\n\n"
                 " [1] Line failures\n"
                 " [2] Segment failures\n"
-                " [3] Station failures\n\n"
+                " [3] Station failures\n"
+                " [4] Most critical segments (every single segment failure)\n"
+                " [5] Most critical stations (every single station failure)\n"
+                " [6] Most critical combinations of segments (several segments failing at once)\n"
+                " [7] Partial degradation (segments, lines or a region keeping part of their capacity)\n\n"
                 " Option: ";
 
         std::cin >> option;
@@ -359,6 +430,22 @@ void Menu::reliability(){
             stationFailures();
             return;
         }
+        else if (option == "4"){
+            criticality(true);
+            return;
+        }
+        else if (option == "5"){
+            criticality(false);
+            return;
+        }
+        else if (option == "6"){
+            multipleCriticality();
+            return;
+        }
+        else if (option == "7"){
+            degradation();
+            return;
+        }
         else if (option == "0"){
             std::cout << "\n";
             return;
@@ -510,8 +597,66 @@ void Menu::stationFailures(){
 }
 
 /**
- * Menu where the user is able to choose what he wants to do for the newly created graph: max flow/minimum cost max flow between two stations
- * or the top-k most affected stations because of failures.\n\n
+ * Asks the user what part of the network is degraded (a segment, a line or a region) and how much of its capacity is
+ * kept, and shows the top-k stations that lose the most flow because of it.\n\n
+ */
+void Menu::degradation(){
+    std::string option;
+    std::vector<std::pair<int, int>> degraded;
+    while(true){
+        std::cout << "\n What part of the network is degraded?\n\n"
+                " [1] A segment\n"
+                " [2] A line\n"
+                " [3] A municipality\n"
+                " [4] A district\n\n"
+                " Option: ";
+        std::cin >> option;
+        if (option == "1" || option == "2" || option == "3" || option == "4") break;
+        else if (option == "0") return;
+        std::cout << "\n Invalid input, try again. \n";
+        std::cin.clear();
+        std::cin.ignore(INT_MAX, '\n');
+    }
+
+    std::string source, target, line, region;
+    if (option == "1"){
+        std::cin.ignore();
+        if (validatePath(source,target) == "0") return;
+    }
+    else if (option == "2"){
+        line = validateLine();
+        if (line == "0") return;
+    }
+    else{
+        std::cin.ignore();
+        region = validateRegion("\n Insert the name of the region (ex: PORTO): ", option == "3");
+        if (region == "0") return;
+    }
+
+    int percent = customTop("\n Percentage of the capacity that is kept (1 to 99, ex: 50): ", 99);
+    if (percent == 0) return;
+
+    if (option == "1") degraded = supervisor->degradation(std::vector<std::pair<std::string,std::string>>{{source, target}}, percent);
+    else if (option == "2") degraded = supervisor->degradation(std::unordered_set<std::string>{line}, percent);
+    else degraded = supervisor->degradation(region, option == "3", percent);
+
+    int choice = showTop(), top;
+    if (choice == 1) top = 10;
+    else if (choice == 2) top = 15;
+    else if (choice == 3) top = customTop("\n Pick a custom top: ", supervisor->getId().size());
+    else return;
+    if (top == 0) return;
+
+    std::vector<std::pair<std::string,int>> difference = supervisor->flowDifference(degraded, top);
+    for (int i = 0; i < (int) difference.size(); i++)
+        std::cout << "\n\033[1m\033[32m " << i+1 << ".\033[0m "<< difference[i].first << " | Flow loss: "
+             << "\033[1m\033[35m" << difference[i].second << "\033[0m \n";
+    std::cout << '\n';
+}
+
+/**
+ * Menu where the user is able to choose what he wants to do for the newly created graph: max flow/minimum cost max flow between two stations,
+ * the top-k most affected stations because of failures or the cheapest alternative routes between two stations.\n\n
  */
 void Menu::subGraphOperations(){
     std::string option;
@@ -519,7 +664,8 @@ void Menu::subGraphOperations(){
         std::cout << "\n What type of information would you like to see?\n\n"
                 " [1] Maximum number of trains that can simultaneously travel between two specific stations\n"
                 " [2] Minimum cost for the maximum flow between two specific stations\n"
-                " [3] Top-k most affected stations\n\n"
+                " [3] Top-k most affected stations\n"
+                " [4] Cheapest alternative routes between two specific stations\n\n"
                 " Option: ";
 
         std::cin >> option;
@@ -543,6 +689,14 @@ void Menu::subGraphOperations(){
             mostAffectedStations();
             return;
         }
+        else if (option == "4"){
+            std::cin.ignore();
+            std::string source, target;
+            validatePath(source,target);
+
+            cheapestRoutes(true,source,target);
+            return;
+        }
         else if (option == "0")
             return;
         else{
@@ -558,16 +712,61 @@ void Menu::subGraphOperations(){
  * created by that failure.\n\n
  */
 void Menu::mostAffectedStations(){
-    std::vector<std::pair<std::string,int>> difference = supervisor->flowDifference(supervisor->getSubGraph());
     int choice = showTop(), top;
     if (choice == 1) top = 10;
     else if (choice == 2) top = 15;
-    else if (choice == 3) top = customTop("\n Pick a custom top: ", difference.size());
+    else if (choice == 3) top = customTop("\n Pick a custom top: ", supervisor->getId().size());
     else return;
+    if (top == 0) return;
 
-    for (int i = 0; i < top; i++)
+    std::vector<std::pair<std::string,int>> difference = supervisor->flowDifference(supervisor->getSubGraph(), top);
+    for (int i = 0; i < (int) difference.size(); i++)
         std::cout << "\n\033[1m\033[32m " << i+1 << ".\033[0m "<< difference[i].first << " | Flow loss: "
-             << "\033[1m\033[35m" << difference[i].second * 2 << "\033[0m \n";
+             << "\033[1m\033[35m" << difference[i].second << "\033[0m \n";
+    std::cout << '\n';
+}
+
+/**
+ * Evaluates the failure of every segment or station of the network and shows the top-k whose failure
+ * causes the largest loss of flow.\n\n
+ * @param segments true for segments, false for stations
+ */
+void Menu::criticality(bool segments){
+    std::vector<std::pair<std::string,int>> losses = segments ? supervisor->criticalSegments() : supervisor->criticalStations();
+    int choice = showTop(), top;
+    if (choice == 1) top = 10;
+    else if (choice == 2) top = 15;
+    else if (choice == 3) top = customTop("\n Pick a custom top: ", losses.size());
+    else return;
+
+    for (int i = 0; i < (int) std::min<size_t>(top, losses.size()); i++)
+        std::cout << "\n\033[1m\033[32m " << i+1 << ".\033[0m "<< losses[i].first << " | Flow loss: "
+             << "\033[1m\033[35m" << losses[i].second << "\033[0m \n";
+    std::cout << '\n';
+}
+
+/**
+ * Asks how many segments fail at the same time and shows the top-k combinations of segments whose failure causes the
+ * largest loss of flow. Combinations are shown as they are found, since the search can take a while.\n\n
+ */
+void Menu::multipleCriticality(){
+    int k = customTop("\n How many segments fail at the same time (1 to 3): ", 3);
+    if (k == 0) return;
+
+    int choice = showTop(), top;
+    if (choice == 1) top = 10;
+    else if (choice == 2) top = 15;
+    else if (choice == 3) top = customTop("\n Pick a custom top: ", 100);
+    else return;
+
+    std::cout << "\n Searching...\n";
+    std::vector<std::pair<std::string,int>> losses = supervisor->criticalSegmentTuples(k, top, [](const std::string& segments, int loss){
+        std::cout << " \033[2m" << segments << " | Flow loss: " << loss << "\033[0m\n";
+    });
+
+    for (int i = 0; i < (int) losses.size(); i++)
+        std::cout << "\n\033[1m\033[32m " << i+1 << ".\033[0m "<< losses[i].first << " | Flow loss: "
+             << "\033[1m\033[35m" << losses[i].second << "\033[0m \n";
     std::cout << '\n';
 }
 
@@ -649,6 +848,26 @@ std::string Menu::validateStation(const std::string& message){
     return station;
 }
 
+/**
+ * Validates municipality or district input.\n\n
+ * @param message message chosen from developers
+ * @param municipality true for a municipality, false for a district
+ */
+std::string Menu::validateRegion(const std::string& message, bool municipality){
+    std::string region;
+    std::cout << message;
+    getline(std::cin,region,'\n');
+
+    while(!supervisor->isRegion(region, municipality)) {
+        if (region == "0") return "0";
+        else std::cout << (municipality ? " That municipality" : " That district") << " does not exist in our database " << '\n';
+        std::cout << " Insert a valid name: ";
+        std::cin.clear();
+        getline(std::cin,region,'\n');
+    }
+    return region;
+}
+
 /**
  * Validates the inputs for both source and target stations.\n\n
  * @param source
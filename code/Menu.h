@@ -23,6 +23,7 @@ private:
     void basicService();
 
     void maxFlow(bool subgraph, const std::string &srcStation, const std::string &destStation);
+    static void showBottleneck(const std::vector<Edge *>& cut);
 
     void mostAmountOfTrains();
 
@@ -30,23 +31,31 @@ private:
     void transportNeeds(int type);
 
     void maxStationFlow(const std::string& station);
+    void timedFlow(const std::string& srcStation, const std::string& destStation);
 
     void costOptimization(bool subgraph, const std::string& srcStation, const std::string& destStation);
+    void showRoutes(bool subgraph, const std::vector<Route>& routes);
+    void cheapestRoutes(bool subgraph, const std::string& srcStation, const std::string& destStation);
 
     void reliability();
 
     void lineFailures();
     void segmentFailures();
     void stationFailures();
+    void degradation();
 
     void subGraphOperations();
     void mostAffectedStations();
 
+    void criticality(bool segments);
+    void multipleCriticality();
+
     static int customTop(const std::string& message, unsigned int n);
     static int showTop();
 
     std::string validateLine();
     std::string validateStation(const std::string& message);
+    std::string validateRegion(const std::string& message, bool municipality);
     std::string validatePath(std::string &source, std::string &target);
 
 };
@@ -17,6 +17,16 @@ bool PriorityQueue::empty() {
     return Heap.size() == 1;
 }
 
+/**
+ * This function removes every element from the priority queue, keeping the memory of the heap for the next search.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+void PriorityQueue::clear() {
+    Heap.resize(1);
+}
+
 /**
  * This function extracts the minimum element from the priority queue.
  *
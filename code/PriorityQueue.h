@@ -15,6 +15,7 @@ public:
     Vertex * extractMin();
 	void decreaseKey(Vertex* x);
 	bool empty();
+	void clear();
 };
 
 #define parent(i) ((i) / 2)
@@ -0,0 +1,242 @@
+#include "RegionFlows.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+static const char MAGIC[4] = {'D', 'A', 'R', 'F'};
+static const uint32_t VERSION = 2;
+
+/**
+ * @param municipality True for the municipalities, false for the districts.
+ *
+ * @return True if the flows of those regions were computed (or loaded) for the current network, false otherwise.
+ */
+bool RegionFlows::isValid(bool municipality) const {
+    return valid[municipality] && stale[municipality].empty();
+}
+
+/**
+ * @param municipality True for the municipalities, false for the districts.
+ *
+ * @return The regions whose flow must be computed again after a change of the network (empty if the flows were
+ * never computed, in which case every region must be computed).
+ */
+const std::unordered_set<std::string>& RegionFlows::getStale(bool municipality) const {
+    return stale[municipality];
+}
+
+/**
+ * @param municipality True for the municipalities, false for the districts.
+ *
+ * @return Vector of pairs region and max flow, in descending order of flow (and ascending order of name on ties).
+ */
+const std::vector<std::pair<std::string, int>>& RegionFlows::getFlows(bool municipality) const {
+    return flows[municipality];
+}
+
+/**
+ * Computes the max flow of every region, in parallel. The sources are the line ends outside the region and the sinks
+ * are its stations. Each thread works on its own copy of the network and on an interleaved share of the regions, so
+ * no graph is shared between threads. If the flows were already computed, only the given regions are replaced (the
+ * stale ones, see invalidate) and the flows of the others are kept.\n\n
+ *
+ * @param municipality True for the municipalities, false for the districts.
+ * @param regions Vector of pairs region and the ids of its stations.
+ * @param graphs Independent copies of the network, one per thread.
+ * @param ends The line ends of the network (see Supervisor::lineEnds).
+ *
+ * @par Time complexity
+ * O(n * V * E² / p), where n is the number of regions, V and E the vertexes and edges of the graph and p the threads
+ */
+void RegionFlows::compute(bool municipality, const std::vector<std::pair<std::string, std::vector<int>>>& regions,
+                          std::vector<Graph> graphs, const std::unordered_map<int, int>& ends) {
+    std::vector<std::pair<std::string, int>> res(regions.size());
+    unsigned int workers = graphs.size();
+
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < workers; w++)
+        pool.emplace_back([&, w]() {
+            for (unsigned int i = w; i < regions.size(); i += workers) {
+                std::unordered_map<int, int> sources = ends, sinks;
+                for (int id : regions[i].second) {
+                    sources.erase(id);
+                    sinks[id] = INF;
+                }
+                res[i] = {regions[i].first, graphs[w].maxFlow(sources, sinks)};
+            }
+        });
+    for (auto& worker : pool)
+        worker.join();
+
+    if (valid[municipality]) {
+        std::unordered_set<std::string> computed;
+        for (const auto& region : regions)
+            computed.insert(region.first);
+        for (const auto& region : flows[municipality])
+            if (computed.find(region.first) == computed.end())
+                res.push_back(region);
+    }
+    sort(res.begin(), res.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    flows[municipality] = std::move(res);
+    valid[municipality] = true;
+    stale[municipality].clear();
+}
+
+/**
+ * Discards the flows of every region, so they are computed again on the next use.
+ */
+void RegionFlows::invalidate() {
+    for (int type = 0; type < 2; type++) {
+        flows[type].clear();
+        valid[type] = false;
+        stale[type].clear();
+    }
+}
+
+/**
+ * Marks the flows of some regions as stale after a change of the network, so only those are computed again on the
+ * next use. Nothing is marked if the flows were not computed yet.\n\n
+ *
+ * @param municipality True for the municipalities, false for the districts.
+ * @param regions The regions whose flow may have changed.
+ *
+ * @par Time complexity
+ * O(n), where n is the number of regions given
+ */
+void RegionFlows::invalidate(bool municipality, const std::unordered_set<std::string>& regions) {
+    if (valid[municipality])
+        stale[municipality].insert(regions.begin(), regions.end());
+}
+
+/**
+ * Loads the flows of the regions saved by a previous run. They are only used if they were computed for the same
+ * network and the same regions, i.e. if both hashes of the file are the given ones.\n\n
+ *
+ * @param path Path of the file.
+ * @param hash Hash of the current network (see FlowMatrix::networkHash).
+ * @param regionHash Hash of the municipality and district of every station (see membershipHash).
+ *
+ * @return True if the file was loaded, false otherwise.
+ *
+ * @par Time complexity
+ * O(n), where n is the number of regions
+ */
+bool RegionFlows::load(const std::string& path, uint64_t hash, uint64_t regionHash) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t fileHash, fileRegionHash;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != VERSION) return false;
+    if (!in.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash)) || fileHash != hash) return false;
+    if (!in.read(reinterpret_cast<char*>(&fileRegionHash), sizeof(fileRegionHash)) || fileRegionHash != regionHash)
+        return false;
+
+    std::vector<std::pair<std::string, int>> loaded[2];
+    bool present[2] = {false, false};
+    for (int type = 0; type < 2; type++) {
+        uint8_t stored;
+        uint32_t count;
+        if (!in.read(reinterpret_cast<char*>(&stored), sizeof(stored))) return false;
+        if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) return false;
+        present[type] = stored != 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t length;
+            int32_t flow;
+            if (!in.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > 1024) return false;
+            std::string name(length, '\0');
+            if (!in.read(&name[0], length) || !in.read(reinterpret_cast<char*>(&flow), sizeof(flow))) return false;
+            loaded[type].emplace_back(std::move(name), flow);
+        }
+    }
+
+    for (int type = 0; type < 2; type++) {
+        flows[type] = std::move(loaded[type]);
+        valid[type] = present[type];
+        stale[type].clear();
+    }
+    return true;
+}
+
+/**
+ * Saves the flows of the regions computed so far next to the network, keyed by its hash and by the hash of the
+ * regions of its stations. A type with stale regions
+ * is saved as not computed. The file is written to a temporary path and then renamed, so an interrupted save never
+ * leaves a partial file.\n\n
+ *
+ * @param path Path of the file.
+ * @param hash Hash of the current network (see FlowMatrix::networkHash).
+ * @param regionHash Hash of the municipality and district of every station (see membershipHash).
+ *
+ * @return True if the file was written, false otherwise.
+ *
+ * @par Time complexity
+ * O(n), where n is the number of regions
+ */
+bool RegionFlows::save(const std::string& path, uint64_t hash, uint64_t regionHash) const {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(MAGIC, sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+        out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+        out.write(reinterpret_cast<const char*>(&regionHash), sizeof(regionHash));
+        for (int type = 0; type < 2; type++) {
+            uint8_t stored = isValid(type);
+            uint32_t count = stored ? flows[type].size() : 0;
+            out.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (uint32_t i = 0; i < count; i++) {
+                const auto& region = flows[type][i];
+                uint32_t length = region.first.size();
+                int32_t flow = region.second;
+                out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.write(region.first.data(), length);
+                out.write(reinterpret_cast<const char*>(&flow), sizeof(flow));
+            }
+        }
+        if (!out) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * Hashes the regions of a network: the municipality and the district of its stations, in id order. The network hash
+ * only covers the stations and the segments, so a change of the region of a station in the CSV files changes this
+ * hash instead, and the flows saved for the old regions are never used.\n\n
+ *
+ * @param graph The network.
+ *
+ * @return 64-bit FNV-1a hash of the regions of the stations.
+ *
+ * @par Time complexity
+ * O(V), where V is the number of vertexes in the graph
+ */
+uint64_t RegionFlows::membershipHash(const Graph& graph) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            hash ^= static_cast<const unsigned char*>(bytes)[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (auto v : graph.getVertexSet()) {
+        int id = v->getId();
+        std::string municipality = v->getStation().getMunicipality(), district = v->getStation().getDistrict();
+        add(&id, sizeof(id));
+        add(municipality.c_str(), municipality.size() + 1);
+        add(district.c_str(), district.size() + 1);
+    }
+    return hash;
+}
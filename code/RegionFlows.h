@@ -0,0 +1,36 @@
+#ifndef DA_REGIONFLOWS_H
+#define DA_REGIONFLOWS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Graph.h"
+
+#define REGION_FLOWS "../data/regions.bin"
+
+class RegionFlows {
+public:
+    bool isValid(bool municipality) const;
+    const std::vector<std::pair<std::string, int>>& getFlows(bool municipality) const;
+    const std::unordered_set<std::string>& getStale(bool municipality) const;
+
+    void compute(bool municipality, const std::vector<std::pair<std::string, std::vector<int>>>& regions,
+                 std::vector<Graph> graphs, const std::unordered_map<int, int>& ends);
+    void invalidate();
+    void invalidate(bool municipality, const std::unordered_set<std::string>& regions);
+
+    bool load(const std::string& path, uint64_t hash, uint64_t regionHash);
+    bool save(const std::string& path, uint64_t hash, uint64_t regionHash) const;
+
+    static uint64_t membershipHash(const Graph& graph);
+
+private:
+    std::vector<std::pair<std::string, int>> flows[2];
+    bool valid[2] = {false, false};
+    std::unordered_set<std::string> stale[2];
+};
+
+#endif //DA_REGIONFLOWS_H
@@ -0,0 +1,39 @@
+#include "Service.h"
+
+/**
+ * Attributes of every service, indexed by the Service value. NONE is used by the edges that are not segments of the
+ * network, like the contracted segments of ChainContraction, which set their own cost.
+ */
+static const ServiceInfo SERVICES[] = {
+        {"", 0},
+        {"STANDARD", 2},
+        {"ALFA PENDULAR", 4}
+};
+
+/**
+ * @param service A service.
+ *
+ * @return Name and cost of one train of the service per segment.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+const ServiceInfo& serviceInfo(Service service) {
+    return SERVICES[static_cast<unsigned char>(service)];
+}
+
+/**
+ * Finds the service with the given name, as written in the CSV file.\n\n
+ *
+ * @param name Name of the service.
+ *
+ * @return The service, or NONE if the name is unknown.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+Service toService(std::string_view name) {
+    if (name == SERVICES[static_cast<unsigned char>(Service::STANDARD)].name) return Service::STANDARD;
+    if (name == SERVICES[static_cast<unsigned char>(Service::ALFA_PENDULAR)].name) return Service::ALFA_PENDULAR;
+    return Service::NONE;
+}
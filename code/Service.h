@@ -0,0 +1,20 @@
+#ifndef DA_SERVICE_H
+#define DA_SERVICE_H
+
+#include <string_view>
+
+enum class Service : unsigned char {
+    NONE,
+    STANDARD,
+    ALFA_PENDULAR
+};
+
+struct ServiceInfo {
+    const char* name;
+    int cost;
+};
+
+const ServiceInfo& serviceInfo(Service service);
+Service toService(std::string_view name);
+
+#endif //DA_SERVICE_H
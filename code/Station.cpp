@@ -12,18 +12,18 @@ Station::Station(const std::string& name,const std::string& district,const std::
     this->line = line;
 }
 
-std::string Station::getName() const {
+const std::string& Station::getName() const {
     return this->name;
 }
-std::string Station::getDistrict() const {
+const std::string& Station::getDistrict() const {
     return this->district;
 }
-std::string Station::getLine() const {
+const std::string& Station::getLine() const {
     return this->line;
 }
-std::string Station::getTownship() const {
+const std::string& Station::getTownship() const {
     return this->township;
 }
-std::string Station::getMunicipality() const {
+const std::string& Station::getMunicipality() const {
     return this->municipality;
 }
\ No newline at end of file
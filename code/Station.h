@@ -9,14 +9,14 @@ class Station{
 public:
     Station(const std::string& name);
     Station(const std::string&, const std::string&, const std::string&, const std::string&, const std::string&);
-    std::string getName() const;
-    std::string getDistrict() const;
-    std::string getMunicipality() const;
-    std::string getTownship() const;
-    std::string getLine() const;
+    const std::string& getName() const;
+    const std::string& getDistrict() const;
+    const std::string& getMunicipality() const;
+    const std::string& getTownship() const;
+    const std::string& getLine() const;
     struct StationHash{
         int operator()(const Station& station) const{
-            std::string c=station.getName();
+            const std::string& c=station.getName();
             int v=0;
             for(char i:c){
                 v=37*v+i;
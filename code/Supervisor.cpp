@@ -3,31 +3,64 @@
 Supervisor::Supervisor() {
     createStations();
     this->graph = originalGraph();
-    stationsFlow();
+    graph.buildLandmarks();
+    this->bridgeIndex = BridgeIndex(graph);
+    this->contraction = ChainContraction(graph);
+    this->csr = CsrGraph(graph);
+    this->flowCsr = csr;
+    this->networkHash = FlowMatrix::networkHash(graph);
+    this->regionHash = RegionFlows::membershipHash(graph);
+    flowMatrix.open(FLOW_MATRIX, networkHash);
+    regionFlows.load(REGION_FLOWS, networkHash, regionHash);
+
+    flowSegments = csr.getSegments();
+    stationFlow.assign(graph.getVertexSet().size(), 0);
+    segmentFlows.assign(graph.getVertexSet().size(), {});
+    flowReady.assign(graph.getVertexSet().size(), 0);
+    warmer = std::thread(&Supervisor::stationsFlow, this);
 }
 
-Station::StationH Supervisor::getStations() const{
+Supervisor::~Supervisor() {
+    stopWarming = true;
+    if (warmer.joinable())
+        warmer.join();
+}
+
+const Station::StationH& Supervisor::getStations() const{
     return this->stations;
 }
 
-std::unordered_map<std::string, int> Supervisor::getId() const{
+const std::unordered_map<std::string, int>& Supervisor::getId() const{
     return this->idStations;
 }
 
-std::unordered_map<std::string, int> Supervisor::getSubGraphStations() const{
-    return this->subGraphStations;
+const FlowMatrix& Supervisor::getFlowMatrix() const {
+    return this->flowMatrix;
 }
 
-Graph Supervisor::getGraph() const {
+const Graph& Supervisor::getGraph() const {
     return this->graph;
 }
 
-Graph Supervisor::getSubGraph() const{
+const Graph& Supervisor::getSubGraph() const{
     return this->subGraph;
 }
 
+/**
+ * Sets the failure scenario used by the subgraph queries and builds its landmarks, bridge index and contracted graph.
+ * The scenario is read from the network as it is now, so a later change of the network discards it (see
+ * networkChanged) and it must be set again.\n\n
+ *
+ * @param subgraph Graph of the failure scenario (see subgraph).
+ *
+ * @par Time complexity
+ * O(L * (V + E) * log(V)), where V is the number of vertexes, E the number of edges and L the number of landmarks
+ */
 void Supervisor::setSubGraph(const Graph& subgraph) {
     this->subGraph = subgraph;
+    subGraph.buildLandmarks();
+    this->subBridgeIndex = BridgeIndex(subgraph);
+    this->subContraction = ChainContraction(subgraph);
 }
 
 /**
@@ -53,66 +86,39 @@ bool Supervisor::isLine(const std::string& line){
 }
 
 /**
- * Creates a new vertex in the graph for the station with the given name,
- * or returns the existing vertex ID if the station already exists in the graph.\n\n
- *
- * @param _graph  The graph in which the vertex is to be created (main graph or subgraph).
- * @param ids  The unordered map that contains the station names and their corresponding vertex IDs.
- * @param name  the name of the station to create in the graph.
- * @param id  the ID of the next vertex to be created in the graph
- *
- * @return The vertex ID of the newly created or existing vertex
- *
+ * Checks if a municipality or district has stations.\n\n
+ * @param region The name of the municipality or district.
+ * @param municipality True for a municipality, false for a district.
+ * @return True if the region exists, false otherwise.
  * @par Time complexity
  * O(1)
  */
-int Supervisor::makeVertex(Graph& _graph, std::unordered_map<std::string, int>& ids, const std::string& name, int &id) {
-    auto it = ids.find(name);
-    int stationId;
-    if (it == ids.end()) {
-        stationId = id++;
-        _graph.addVertex(stationId, *stations.find(name));
-        ids[name] = stationId;
-    }
-    else
-        stationId = it->second;
-    return stationId;
+bool Supervisor::isRegion(const std::string& region, bool municipality){
+    const auto& regions = municipality ? municipalityStations : districtStations;
+    return regions.find(region) != regions.end();
 }
 
 /**
- * This function removes quotes from a string field that contains a quoted string.\n\n
- *
- * @param iss  The istringstream object that contains the field to process.
- * @param field The string field containing a quoted string to process.
- *
- * @return A string containing the processed text with the quotes removed.
+ * Creates a new vertex in the graph for the station with the given name, with the next free global ID,
+ * or returns the global ID of the station if it already has one.\n\n
  *
- * @par Time complexity
- * O(n), where n is the length of the string field
- */
-std::string Supervisor::removeQuotes(std::istringstream& iss, std::string field){
-    std::string s = field.substr(1);
-
-    while (!iss.eof() && s.back() != '\"') {
-        getline(iss, field, ',');
-        s += ',' + field;
-    }
-    return s.substr(0, s.length() - 1);
-}
-
-/**
- * Extracts the next field from an istringstream object and checks if it needs quotes to be removed.\n\n
+ * @param _graph  The graph in which the vertex is to be created.
+ * @param name  the name of the station to create in the graph.
  *
- * @param iss The istringstream object containing the input text
- * @param field The string field containing a quoted string to process.
+ * @return The global ID of the station
  *
  * @par Time complexity
- * O(n), where n is the length of the string field
+ * O(1)
  */
-void Supervisor::checkField(std::istringstream& iss, std::string& field){
-    getline(iss,field,',');
-    if (field[0] == '\"')
-        field = removeQuotes(iss, field);
+int Supervisor::makeVertex(Graph& _graph, const std::string& name) {
+    auto it = idStations.find(name);
+    if (it != idStations.end())
+        return it->second;
+
+    int stationId = (int) idStations.size();
+    _graph.addVertex(stationId, *stations.find(name));
+    idStations[name] = stationId;
+    return stationId;
 }
 
 /**
@@ -128,71 +134,120 @@ void Supervisor::checkField(std::istringstream& iss, std::string& field){
  */
 void Supervisor::createStations() {
 
-    std::ifstream myFile;
-    std::string currentLine, name, district, municipality, township, line;
-
-    myFile.open("../data/stations.csv");
-    getline(myFile, currentLine);
+    CsvReader reader("../data/stations.csv");
+    std::vector<std::string_view> fields;
+    reader.readRow(fields);
 
-    while (getline(myFile,currentLine)){
-        std::istringstream iss(currentLine);
+    while (reader.readRow(fields)){
+        if (fields.size() < 5) continue;
 
-        checkField(iss,name);
-        checkField(iss,district);
-        checkField(iss,municipality);
-        checkField(iss,township);
-        checkField(iss,line);
-
-        if (line.back() == '\r') line.pop_back();
+        const std::string& line = reader.intern(fields[4]);
         if (line == "Rede Espanhola") continue;
 
-        Station station(name,district,municipality,township,line);
+        const std::string& district = reader.intern(fields[1]);
+        const std::string& municipality = reader.intern(fields[2]);
+
+        Station station(reader.intern(fields[0]),district,municipality,reader.intern(fields[3]),line);
         stations.insert(station);
         lines.insert(line);
         municipalityStations[municipality].insert(station);
         districtStations[district].insert(station);
     }
-    myFile.close();
 }
 
 /**
- * This function reads and processes the CSV file "network.csv", which contains information about the
- * connections between the different stations. A graph of the railway network is created, where each station is
- * represented as a vertex and each connection is represented as an edge.\n\n
+ * This function reads the CSV file "network.csv" and creates a graph with every segment that is not excluded by the
+ * given failure, with the changes made to the main network since then (see applyChange). Each station is represented as a vertex and each segment as an edge. The file is mapped into
+ * memory and the station names are interned, so each name is only copied once. An optional fifth column, Duration,
+ * gives the number of time slots a train takes to cross the segment (1 if it is missing), used by the time-expanded
+ * network.\n\n
+ * Every station has one global ID, given the first time the network is read: the graphs of the failures have a vertex
+ * for every station of the main graph, with the same ID (a station that lost all its segments is left isolated), so
+ * the results of a station are indexed by the same ID in every graph.\n\n
+ *
+ * @param failure Function that checks if the segment between two stations must be excluded.
  *
  * @return Graph created using the CSV file
  *
  * @par Time complexity
  * O(n), where n is the number of lines in the CSV file
  */
-Graph Supervisor::originalGraph() {
+Graph Supervisor::readNetwork(const std::function<bool(const std::string&, const std::string&)>& failure) {
     Graph _graph;
-    idStations.clear();
-    std::ifstream inFile;
-    std::string source, target, service, line, x;
-    int capacity, idA, idB, id=0;
-    inFile.open("../data/network.csv");
-    getline(inFile, line);
+    for (auto v : graph.getVertexSet())
+        _graph.addVertex(v->getId(), v->getStation());
+    int idA, idB;
 
-    while(getline(inFile, line)) {
+    CsvReader reader("../data/network.csv");
+    std::vector<std::string_view> fields;
+    reader.readRow(fields);
 
-        std::istringstream is(line);
+    while (reader.readRow(fields)) {
+        if (fields.size() < 4) continue;
 
-        checkField(is, source);
-        checkField(is,target);
-        checkField(is, x); capacity = stoi(x);
-        checkField(is, service);
+        const std::string& source = reader.intern(fields[0]);
+        const std::string& target = reader.intern(fields[1]);
+        if (failure(source, target)) continue;
 
-        if (service.back() == '\r') service.pop_back();
+        idA = makeVertex(_graph, source);
+        idB = makeVertex(_graph, target);
+        int duration = fields.size() > 4 ? std::min(65535, std::max(1, CsvReader::toInt(fields[4]))) : 1;
+        _graph.addEdge(idA, idB, CsvReader::toInt(fields[2]), toService(fields[3]), duration);
+    }
+    for (const Change& change : changes)
+        applyChange(_graph, change, failure);
+    return _graph;
+}
 
-        idA = makeVertex(_graph,idStations,source, id);
-        idB = makeVertex(_graph,idStations,target, id);
+/**
+ * Applies a change made to the main network (see addSegment, setSegmentCapacity, removeSegment and closeStation) to
+ * a graph read from the CSV file, so every graph read afterwards (failures, flow matrix, region flows) has it too.
+ * A new segment is left out if the failure excludes it; a change of a segment that is not in the graph is ignored.
+ * Parallel segments are told apart by the index recorded with the change (see findSegment).\n\n
+ *
+ * @param _graph The graph to change.
+ * @param change The change.
+ * @param failure Function that checks if the segment between two stations must be excluded.
+ *
+ * @par Time complexity
+ * O(d), where d is the degree of the stations changed
+ */
+void Supervisor::applyChange(Graph& _graph, const Change& change, const std::function<bool(const std::string&, const std::string&)>& failure) {
+    int source = idStations.at(change.source);
+    if (change.kind == Change::CLOSE) {
+        std::vector<Edge*> segments = _graph.findVertex(source)->getAdj();
+        for (Edge* e : segments)
+            _graph.removeSegment(e);
+        return;
+    }
 
-        _graph.addEdge(idA, idB, capacity, service);
+    int target = idStations.at(change.target);
+    if (change.kind == Change::ADD) {
+        if (!failure(change.source, change.target))
+            _graph.addEdge(source, target, change.capacity, change.service, change.duration);
+        return;
     }
 
-    inFile.close();
-    return _graph;
+    Edge* edge = _graph.findEdge(source, target, change.parallel);
+    if (edge == nullptr) return;
+    if (change.kind == Change::CAPACITY)
+        _graph.setSegmentCapacity(edge, change.capacity);
+    else
+        _graph.removeSegment(edge);
+}
+
+/**
+ * This function reads and processes the CSV file "network.csv", which contains information about the
+ * connections between the different stations. A graph of the railway network is created, where each station is
+ * represented as a vertex and each connection is represented as an edge.\n\n
+ *
+ * @return Graph created using the CSV file
+ *
+ * @par Time complexity
+ * O(n), where n is the number of lines in the CSV file
+ */
+Graph Supervisor::originalGraph() {
+    return readNetwork([](const std::string&, const std::string&) { return false; });
 }
 
 /**
@@ -208,35 +263,9 @@ Graph Supervisor::originalGraph() {
  * O(n), where n is the number of lines in the CSV file
  */
 Graph Supervisor::subgraph(const std::unordered_set<std::string>& failedLines){
-
-    Graph _subGraph;
-    subGraphStations.clear();
-    std::ifstream inFile;
-    std::string source, target, service, line, x;
-    int capacity, idA, idB, id=0;
-    inFile.open("../data/network.csv");
-    getline(inFile, line);
-
-    while(getline(inFile, line)) {
-
-        std::istringstream is(line);
-
-        checkField(is, source);
-        checkField(is,target);
-
-        checkField(is, x); capacity = stoi(x);
-        checkField(is, service);
-
-        if (service.back() == '\r') service.pop_back();
-
-        if (!lineFailure(failedLines,source,target)) {
-            idA = makeVertex(_subGraph,subGraphStations, source, id);
-            idB = makeVertex(_subGraph,subGraphStations,target, id);
-            _subGraph.addEdge(idA, idB, capacity, service);
-        }
-    }
-    inFile.close();
-    return _subGraph;
+    return readNetwork([&](const std::string& source, const std::string& target) {
+        return lineFailure(failedLines, source, target);
+    });
 }
 
 /**
@@ -252,35 +281,9 @@ Graph Supervisor::subgraph(const std::unordered_set<std::string>& failedLines){
  * O(n), where n is the number of segments in the CSV file
  */
 Graph Supervisor::subgraph(const std::vector<std::pair<std::string, std::string>>& failedSegments){
-
-    Graph _subGraph;
-    subGraphStations.clear();
-    std::ifstream inFile;
-    std::string source, target, service, line, x;
-    int capacity, idA, idB, id=0;
-    inFile.open("../data/network.csv");
-    getline(inFile, line);
-
-    while(getline(inFile, line)) {
-
-        std::istringstream is(line);
-
-        checkField(is, source);
-        checkField(is,target);
-
-        checkField(is, x); capacity = stoi(x);
-        checkField(is, service);
-
-        if (service.back() == '\r') service.pop_back();
-
-        if (!segmentFailure(failedSegments,source,target)) {
-            idA = makeVertex(_subGraph,subGraphStations, source, id);
-            idB = makeVertex(_subGraph,subGraphStations,target, id);
-            _subGraph.addEdge(idA, idB, capacity, service);
-        }
-    }
-    inFile.close();
-    return _subGraph;
+    return readNetwork([&](const std::string& source, const std::string& target) {
+        return segmentFailure(failedSegments, source, target);
+    });
 }
 
 /**
@@ -296,35 +299,9 @@ Graph Supervisor::subgraph(const std::vector<std::pair<std::string, std::string>
  * O(n), where n is the number of stations in the CSV file
  */
 Graph Supervisor::subgraph(const Station::StationH& failedStations){
-
-    Graph _subGraph;
-    subGraphStations.clear();
-    std::ifstream inFile;
-    std::string source, target, service, line, x;
-    int capacity, idA, idB, id=0;
-    inFile.open("../data/network.csv");
-    getline(inFile, line);
-
-    while(getline(inFile, line)) {
-
-        std::istringstream is(line);
-
-        checkField(is, source);
-        checkField(is,target);
-
-        checkField(is, x); capacity = stoi(x);
-        checkField(is, service);
-
-        if (service.back() == '\r') service.pop_back();
-
-        if (!stationFailure(failedStations,source,target)) {
-            idA = makeVertex(_subGraph,subGraphStations, source, id);
-            idB = makeVertex(_subGraph,subGraphStations,target, id);
-            _subGraph.addEdge(idA, idB, capacity, service);
-        }
-    }
-    inFile.close();
-    return _subGraph;
+    return readNetwork([&](const std::string& source, const std::string& target) {
+        return stationFailure(failedStations, source, target);
+    });
 }
 
 /**
@@ -340,7 +317,7 @@ Graph Supervisor::subgraph(const Station::StationH& failedStations){
  * @par Time complexity
  * O(1)
  */
-bool Supervisor::stationFailure(Station::StationH failedStations, const std::string& source, const std::string& target){
+bool Supervisor::stationFailure(const Station::StationH& failedStations, const std::string& source, const std::string& target){
     return (failedStations.find(source) != failedStations.end() || failedStations.find(target) != failedStations.end());
 }
 
@@ -357,7 +334,7 @@ bool Supervisor::stationFailure(Station::StationH failedStations, const std::str
  * @par Time complexity
  * O(1)
  */
-bool Supervisor::lineFailure(std::unordered_set<std::string> failedLines, const std::string& source, const std::string& target){
+bool Supervisor::lineFailure(const std::unordered_set<std::string>& failedLines, const std::string& source, const std::string& target){
     Station src = *stations.find(source);
     Station dest = *stations.find(target);
     return (failedLines.find(src.getLine()) != failedLines.end() && failedLines.find(dest.getLine()) != failedLines.end());
@@ -381,18 +358,61 @@ bool Supervisor::segmentFailure(const std::vector<std::pair<std::string,std::str
 }
 
 /**
- * Calculates the flow of all the stations.\n\n
+ * Calculates the flow of a station, from the Super-Source of the CSR copy of the main graph kept for the station
+ * flows, and keeps the segments it goes through, which bound how much of it a failure can take away. Each flow is
+ * only calculated the first time it is needed, and remembered.\n\n
+ *
+ * @param id wanted station id
+ *
+ * @return Max flow of the station
+ *
+ * @par Time complexity
+ * O(1) if it was already calculated, otherwise O(V * E²), where V is the number of vertexes and E the number of
+ * edges in the graph
+ */
+int Supervisor::stationFlowOf(int id){
+    std::lock_guard<std::mutex> guard(flowLock);
+    if (!flowReady[id]) {
+        stationFlow[id] = flowCsr.superSourceFlow(id);
+        for (int segment : flowSegments)
+            if (flowCsr.getFlow(segment) != 0)
+                segmentFlows[id].emplace_back(segment, std::abs(flowCsr.getFlow(segment)));
+        flowReady[id] = 1;
+    }
+    return stationFlow[id];
+}
+
+/**
+ * Calculates the flow of all the stations that were not calculated yet. The constructor runs it on a background
+ * thread, so the flows are usually ready before they are asked for, without delaying the start of the program;
+ * a flow asked for before that is calculated on the spot.\n\n
  *
  * @par Time complexity
  * O(V² * E²), where V is the number of vertexes and E the number of edges in the graph
  */
 void Supervisor::stationsFlow(){
-    int flow;
-    for (auto v: graph.getVertexSet()){
-        createSuperSourceGraph(true,originalGraph(),v->getId());
-        flow = superGraph.maxFlow(superGraphStations["Super-Source"], v->getId());
-        stationFlow[v->getStation().getName()] = flow;
+    for (int id = 0; id < (int) stationFlow.size() && !stopWarming; id++)
+        stationFlowOf(id);
+}
+
+/**
+ * Finds the vertex ids of a set of stations in the main graph, ignoring the stations without any segment.\n\n
+ *
+ * @param targetStations unordered set of stations
+ *
+ * @return Vector of vertex ids
+ *
+ * @par Time complexity
+ * O(n), where n is the size of targetStations
+ */
+std::vector<int> Supervisor::stationIds(const Station::StationH& targetStations){
+    std::vector<int> ids;
+    for (const auto& station : targetStations){
+        auto it = idStations.find(station.getName());
+        if (it != idStations.end())
+            ids.push_back(it->second);
     }
+    return ids;
 }
 
 /**
@@ -403,15 +423,16 @@ void Supervisor::stationsFlow(){
  * @return Max flow of a station
  *
  * @par Time complexity
- * O(1), where V is the number of vertexes and E the number of edges in the graph
+ * O(1) once calculated, otherwise O(V * E²), where V is the number of vertexes and E the number of edges in the graph
  */
 int Supervisor::maxStationFlow(const std::string& station){
-    return stationFlow[station];
+    auto it = idStations.find(station);
+    return it == idStations.end() ? 0 : stationFlowOf(it->second);
 }
 
 /**
- * Calculates the max flow of a specific station from the superGraph which contains a Super-Source connected
- * to all vertexes that have 1 outgoing edge.\n\n
+ * Calculates the max flow of a specific station when every vertex with only 1 outgoing edge (except the station) is a
+ * source, using the multi-source max flow of the graph instead of a copy with a Super-Source.\n\n
  *
  * @param _graph wanted graph
  * @param target  wanted station id
@@ -421,30 +442,392 @@ int Supervisor::maxStationFlow(const std::string& station){
  * O(V * E²), where V is the number of vertexes and E the number of edges in the graph
  */
 int Supervisor::finalStationFlow(const Graph &_graph, int target){
-    createSuperSourceGraph(false,_graph,target);
-    return superGraph.maxFlow(superGraphStations["Super-Source"], target);
+    Graph flowGraph = _graph;
+    std::unordered_map<int, int> sources = lineEnds(_graph);
+    sources.erase(target);
+    return flowGraph.maxFlow(sources, {{target, INF}});
 }
 
 /**
- * This function calculates the reduction of flow created by failures of lines, stations or segments.\n\n
+ * Finds the ends of the lines of a graph, the vertexes with only 1 outgoing edge, which are the sources of the flow
+ * of the stations and regions.\n\n
  *
- * @param _subGraph subGraph created because of line,station or segment failures
- * @return Vector containing all stations and the difference of flow affected by the failures
+ * @param _graph wanted graph
+ * @return Map of vertex id to capacity (no limit) of each line end
  *
  * @par Time complexity
- * O(V² * E²), where V is the number of vertexes and E the number of edges in the graph
+ * O(V), where V is the number of vertexes in the graph
+ */
+std::unordered_map<int, int> Supervisor::lineEnds(const Graph& _graph){
+    std::unordered_map<int, int> ends;
+    for (auto v: _graph.getVertexSet())
+        if (v->getAdj().size() == 1)
+            ends[v->getId()] = INF;
+    return ends;
+}
+
+/**
+ * Calculates the max flow between two stations of the main graph or of the subGraph, using the bridge index of that
+ * graph instead of running max flow on the whole network. On the main graph, the flow matrix is used if it was built
+ * for the current network (see buildFlowMatrix).\n\n
+ *
+ * @param subgraph true for the subGraph (line/station/segment failure)
+ * @param source source station id
+ * @param target target station id
+ *
+ * @return Max flow between the two stations
+ *
+ * @par Time complexity
+ * O(1) with the flow matrix, otherwise O(D + C * E²), where D is the depth of the bridge forest and C, E the vertexes
+ * and edges of the crossed components
+ */
+int Supervisor::pairMaxFlow(bool subgraph, int source, int target){
+    if (!subgraph && flowMatrix.isOpen()) return flowMatrix.maxFlow(source, target);
+    return subgraph ? subBridgeIndex.maxFlow(source, target) : bridgeIndex.maxFlow(source, target);
+}
+
+/**
+ * Finds the segments that limit the max flow between two stations of the main graph or of the subGraph: a minimum
+ * cut taken from the bridge index, which is a single bridge or a cut inside one of the crossed components (see
+ * BridgeIndex::minCut).\n\n
+ *
+ * @param subgraph true for the subGraph (line/station/segment failure)
+ * @param source source station id
+ * @param target target station id
+ *
+ * @return Edges of the minimum cut, from the side of the source to the side of the target
+ *
+ * @par Time complexity
+ * O(D + C * E²), where D is the depth of the bridge forest and C, E the vertexes and edges of the crossed components
  */
-std::vector<std::pair<std::string,int>> Supervisor::flowDifference(const Graph& _subGraph){
-    std::vector<std::pair<std::string,int>> res;
-    int initial, final, difference;
-    std::string station;
-
-    for (auto vertex: subGraph.getVertexSet()){
-        station = vertex->getStation().getName();
-        initial = stationFlow[station];
-        final = finalStationFlow(_subGraph,vertex->getId());
-        difference = initial - final;
-        res.emplace_back(vertex->getStation().getName(), difference);
+std::vector<Edge *> Supervisor::bottleneck(bool subgraph, int source, int target){
+    return subgraph ? subBridgeIndex.minCut(source, target) : bridgeIndex.minCut(source, target);
+}
+
+/**
+ * Calculates the routes followed by the trains between two stations of the main graph or of the subGraph when the
+ * maximum number of trains travels at the minimum cost, on the graph where every unbranched line segment is
+ * contracted into a single segment (see ChainContraction::routes). The total cost is the sum of the cost of each
+ * route times its trains.\n\n
+ *
+ * @param subgraph true for the subGraph (line/station/segment failure)
+ * @param source source station id
+ * @param target target station id
+ *
+ * @return Routes: station ids from the source to the target, number of trains and cost of one train
+ *
+ * @par Time complexity
+ * O(T * S² * log(T) + S * P * k), where T is the number of terminals and S the number of segments in the reduced
+ * graph, P the number of routes and k the number of stations of the longest chain
+ */
+std::vector<Route> Supervisor::routes(bool subgraph, int source, int target){
+    return subgraph ? subContraction.routes(source, target) : contraction.routes(source, target);
+}
+
+/**
+ * Finds the k cheapest alternative routes (without repeated stations) between two stations of the main graph or of
+ * the subGraph, by the cost of the service of each segment, for rerouting trains.\n\n
+ *
+ * @param subgraph true for the subGraph (line/station/segment failure)
+ * @param source source station id
+ * @param target target station id
+ * @param k number of routes wanted
+ *
+ * @return Routes, cheapest first: station ids from the source to the target, number of trains the route can take
+ * and cost of one train
+ *
+ * @par Time complexity
+ * O(k * V * (V + E) * log(V)), where V is the number of vertexes and E the number of edges in the graph
+ */
+std::vector<Route> Supervisor::cheapestRoutes(bool subgraph, int source, int target, unsigned int k){
+    return KShortestPaths(subgraph ? subGraph : graph).find(source, target, k);
+}
+
+/**
+ * Calculates how many trains can travel between two stations of the main graph within a horizon of time slots, taking
+ * the duration of each segment into account, and the minimum total cost of those trains, on the time-expanded
+ * network.\n\n
+ *
+ * @param source source station id
+ * @param target target station id
+ * @param slots number of time slots of the horizon
+ *
+ * @return Pair with the maximum number of trains and their minimum total cost
+ *
+ * @par Time complexity
+ * O(F * T * (V + E) * log(T * V)), where F is the flow, T the number of slots, V the number of vertexes and E the
+ * number of edges
+ */
+std::pair<int, int> Supervisor::timedFlow(int source, int target, int slots) {
+    TimeExpandedGraph timeExpanded(graph, slots);
+    int cost = timeExpanded.minCost(source, target);
+    return {timeExpanded.getFlowValue(), cost};
+}
+
+/**
+ * Computes the max flow of every pair of stations of the intact network, using all the threads given, and stores
+ * them in the flow matrix file, which is then used to answer those queries. The file is keyed by
+ * the hash of the network, so it is ignored once the CSV files change until it is built again.\n\n
+ *
+ * @param threads Number of threads (0 for the number of cores).
+ *
+ * @return True if the matrix was built and opened, false otherwise.
+ *
+ * @par Time complexity
+ * O(V² * (D + C * E²) / p), where V is the number of stations, D the depth of the bridge forest, C and E the vertexes
+ * and edges of the largest 2-edge-connected component and p the threads
+ */
+bool Supervisor::buildFlowMatrix(unsigned int threads) {
+    flowMatrix.close();
+    if (!FlowMatrix::build([this]() { return originalGraph(); }, FLOW_MATRIX, threads)) return false;
+    return flowMatrix.open(FLOW_MATRIX, networkHash);
+}
+
+/**
+ * Finds the pairs of stations that require the most trains, i.e. with the largest max flow of the intact network.
+ * The flow matrix answers it when it was built for the current network; otherwise a flow-equivalent tree of the
+ * network is built (one max flow per station, using every core) and the pairs are read from it.\n\n
+ *
+ * @param pairs Vector where the pairs (source < target) are stored, in ascending order.
+ *
+ * @return The largest max flow between two stations.
+ *
+ * @par Time complexity
+ * O(V²) with the flow matrix, otherwise O(V * C * E² / p), where V is the number of stations, C and E the vertexes and
+ * edges of the largest 2-edge-connected component and p the threads
+ */
+int Supervisor::busiestPairs(std::vector<std::pair<int, int>>& pairs) {
+    if (flowMatrix.isOpen())
+        return flowMatrix.busiestPairs(pairs);
+    return CutTree([this]() { return originalGraph(); }, 0).busiestPairs(pairs);
+}
+
+/**
+ * This function calculates the reduction of flow created by failures of lines, stations or segments.
+ * The sources are the line ends of the intact network (the stations with a single segment before any failure), the
+ * same definition as Contingency: a station left with a single segment by the failures does not become a source,
+ * and a line end that lost its segment sends nothing.\n\n
+ * Each segment of the main network is matched with the exact edge of the subGraph that stands for it (the same
+ * stations and service, preferring the same capacity), so parallel segments between the same two stations are told
+ * apart; a segment without a match failed. The failed segments are then closed on a copy of the CSR graph of the main
+ * network, like a degradation to no capacity (see lossRanking), so the subGraph itself is never copied nor changed.
+ * Stations left without any segment are not listed.\n\n
+ *
+ * @param _subGraph subGraph created because of line,station or segment failures (with the station ids of the main
+ * graph)
+ * @param k number of stations wanted (0 for all of them)
+ * @return Vector containing the k stations most affected by the failures and their difference of flow, ordered in
+ * descending order
+ *
+ * @par Time complexity
+ * O(V * d² + V² * E²), where V is the number of vertexes, E the number of edges and d the largest degree in the graph,
+ * in the worst case
+ */
+std::vector<std::pair<std::string,int>> Supervisor::flowDifference(const Graph& _subGraph, unsigned int k){
+    std::vector<std::pair<int, int>> capacities;
+    std::vector<char> matched;
+    std::vector<int> capacity;
+    for (auto vertex: graph.getVertexSet()){
+        const std::vector<Edge*>& adj = vertex->getAdj();
+        Vertex* subVertex = _subGraph.findVertex(vertex->getId());
+        matched.assign(adj.size(), 0);
+        capacity.assign(adj.size(), 0);
+
+        if (subVertex != nullptr)
+            for (auto edge : subVertex->getAdj()) {
+                int match = -1;
+                for (int i = 0; i < (int) adj.size(); i++) {
+                    if (matched[i] || adj[i]->getDest()->getId() != edge->getDest()->getId() ||
+                        adj[i]->getService() != edge->getService()) continue;
+                    if (match == -1) match = i;
+                    if (adj[i]->getCapacity() == edge->getCapacity()) {
+                        match = i;
+                        break;
+                    }
+                }
+                if (match == -1) continue;
+                matched[match] = 1;
+                capacity[match] = edge->getCapacity();
+            }
+
+        int first = csr.getArcs(vertex->getId()).first;
+        for (int i = 0; i < (int) adj.size(); i++)
+            if (first + i < csr.getReverse(first + i) && capacity[i] < adj[i]->getCapacity())
+                capacities.emplace_back(first + i, capacity[i]);
+    }
+    return lossRanking(capacities, _subGraph, k);
+}
+
+/**
+ * Lists the segments of the main network that keep only part of their capacity, such as a segment reduced to single
+ * track working. The result is an overlay of capacities for flowDifference: the network itself is not changed.\n\n
+ *
+ * @param degraded Function that checks if the segment between two station ids is degraded.
+ * @param percent Percentage of the capacity that the degraded segments keep (0 to 100).
+ *
+ * @return Vector of pairs segment (edge index of the CSR copy of the main graph) and reduced capacity
+ *
+ * @par Time complexity
+ * O(E), where E is the number of edges in the graph
+ */
+std::vector<std::pair<int, int>> Supervisor::degradation(const std::function<bool(int, int)>& degraded, int percent) const {
+    percent = std::max(0, std::min(100, percent));
+    std::vector<std::pair<int, int>> res;
+    for (int segment : csr.getSegments())
+        if (degraded(csr.getOrigin(segment), csr.getTarget(segment)))
+            res.emplace_back(segment, (int) ((long long) csr.getCapacity(segment) * percent / 100));
+    return res;
+}
+
+/**
+ * This function lists the given segments (in either direction) with their capacity reduced to a percentage.\n\n
+ *
+ * @param segments The segments that are degraded.
+ * @param percent Percentage of the capacity that they keep (0 to 100).
+ *
+ * @return Vector of pairs segment and reduced capacity (see degradation)
+ *
+ * @par Time complexity
+ * O(E + n), where E is the number of edges in the graph and n the number of segments given
+ */
+std::vector<std::pair<int, int>> Supervisor::degradation(const std::vector<std::pair<std::string, std::string>>& segments, int percent){
+    std::set<std::pair<int, int>> ids;
+    for (const auto& segment : segments) {
+        auto source = idStations.find(segment.first), target = idStations.find(segment.second);
+        if (source == idStations.end() || target == idStations.end()) continue;
+        ids.emplace(source->second, target->second);
+        ids.emplace(target->second, source->second);
+    }
+    return degradation([&ids](int source, int target) {
+        return ids.find({source, target}) != ids.end();
+    }, percent);
+}
+
+/**
+ * This function lists the segments of the given lines (both stations in one of them, as in a line failure) with their
+ * capacity reduced to a percentage.\n\n
+ *
+ * @param degradedLines The lines that are degraded.
+ * @param percent Percentage of the capacity that their segments keep (0 to 100).
+ *
+ * @return Vector of pairs segment and reduced capacity (see degradation)
+ *
+ * @par Time complexity
+ * O(E), where E is the number of edges in the graph
+ */
+std::vector<std::pair<int, int>> Supervisor::degradation(const std::unordered_set<std::string>& degradedLines, int percent){
+    auto inLines = [&](int id) {
+        return degradedLines.find(graph.findVertex(id)->getStation().getLine()) != degradedLines.end();
+    };
+    return degradation([&](int source, int target) { return inLines(source) && inLines(target); }, percent);
+}
+
+/**
+ * This function lists the segments with at least one station in a municipality or district with their capacity
+ * reduced to a percentage.\n\n
+ *
+ * @param region The name of the municipality or district.
+ * @param municipality True for a municipality, false for a district.
+ * @param percent Percentage of the capacity that its segments keep (0 to 100).
+ *
+ * @return Vector of pairs segment and reduced capacity (see degradation)
+ *
+ * @par Time complexity
+ * O(E), where E is the number of edges in the graph
+ */
+std::vector<std::pair<int, int>> Supervisor::degradation(const std::string& region, bool municipality, int percent){
+    auto inRegion = [&](int id) {
+        const Station& station = graph.findVertex(id)->getStation();
+        return (municipality ? station.getMunicipality() : station.getDistrict()) == region;
+    };
+    return degradation([&](int source, int target) { return inRegion(source) || inRegion(target); }, percent);
+}
+
+/**
+ * This function calculates the reduction of flow created by a partial degradation of the network, where some
+ * segments keep only part of their capacity. The line ends are the ones of the intact network, like in the other
+ * overload (see lossRanking).\n\n
+ *
+ * @param degraded Vector of pairs segment and reduced capacity (see degradation)
+ * @param k number of stations wanted (0 for all of them)
+ * @return Vector containing the k stations most affected by the degradation and their difference of flow, ordered
+ * in descending order
+ *
+ * @par Time complexity
+ * O(V² * E²), where V is the number of vertexes and E the number of edges in the graph, in the worst case
+ */
+std::vector<std::pair<std::string,int>> Supervisor::flowDifference(const std::vector<std::pair<int, int>>& degraded, unsigned int k){
+    return lossRanking(degraded, graph, k);
+}
+
+/**
+ * Ranks the stations by the flow they lose when some segments of the main network keep only part of their capacity
+ * (none, for a failed segment). The reduced capacities are set on a copy of the CSR graph of the main network, so no
+ * graph is built again and the sources stay the line ends of the intact network.\n\n
+ * A max flow that sent f trains through a segment now limited to c can still send all but f - c of them, so the sum
+ * of that excess over the reduced segments (at most the flow itself) bounds the reduction of a station. A station
+ * whose flow fits in the reduced capacities loses nothing, and the search stops as soon as no station left can enter
+ * the top-k.\n\n
+ *
+ * @param capacities Vector of pairs segment (edge index of the CSR copy of the main graph) and reduced capacity
+ * @param _graph graph whose stations with at least one segment are ranked
+ * @param k number of stations wanted (0 for all of them)
+ * @return Vector containing the k stations that lose the most flow and their difference of flow, ordered in
+ * descending order
+ *
+ * @par Time complexity
+ * O(V² * E²), where V is the number of vertexes and E the number of edges in the graph, in the worst case
+ */
+std::vector<std::pair<std::string,int>> Supervisor::lossRanking(const std::vector<std::pair<int, int>>& capacities, const Graph& _graph, unsigned int k){
+    CsrGraph reducedCsr = csr;
+    std::vector<int> reduced(csr.getArcs(csr.getSuperSource()).second, -1);
+    for (const auto& segment : capacities) {
+        if (segment.second >= csr.getCapacity(segment.first)) continue;
+        reducedCsr.setSegmentCapacity(segment.first, segment.second);
+        reduced[segment.first] = reduced[csr.getReverse(segment.first)] = segment.second;
+    }
+
+    std::vector<std::pair<int, Vertex*>> order;
+    for (auto vertex: _graph.getVertexSet()){
+        if (vertex->getAdj().empty()) continue;
+        int initial = stationFlowOf(vertex->getId()), excess = 0;
+        for (const auto& segment : segmentFlows[vertex->getId()])
+            if (reduced[segment.first] != -1) excess += std::max(0, segment.second - reduced[segment.first]);
+        order.emplace_back(std::min(initial, excess), vertex);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<int, Vertex*>& a, const std::pair<int, Vertex*>& b){
+        return a.first > b.first;
+    });
+
+    TopK<std::string, int> top(k);
+    for (const auto& item : order){
+        if (!top.canEnter(item.first)) break;
+        Vertex* vertex = item.second;
+        int loss = item.first == 0 ? 0 : stationFlow[vertex->getId()] - reducedCsr.superSourceFlow(vertex->getId());
+        top.push(vertex->getStation().getName(), loss);
+    }
+
+    return top.sorted();
+}
+
+/**
+ * This function calculates, for every segment of the network, how much of the total flow of the stations is lost
+ * if that segment alone fails (N-1 contingency analysis), and orders the segments by descending loss. The sources
+ * are the line ends of the intact network (see Contingency), as in flowDifference.\n\n
+ *
+ * @return Vector of pairs segment ("source - target") and flow lost, ordered in descending order
+ *
+ * @par Time complexity
+ * O(S * k * V * E² / p), where S is the number of segments, k the station flows that use each one and p the threads
+ */
+std::vector<std::pair<std::string, int>> Supervisor::criticalSegments() {
+    Contingency contingency(csr);
+    std::vector<std::pair<std::string, int>> res;
+
+    for (const auto& loss : contingency.segmentLosses(0)) {
+        std::string source = graph.findVertex(csr.getOrigin(loss.first))->getStation().getName();
+        std::string target = graph.findVertex(csr.getTarget(loss.first))->getStation().getName();
+        res.emplace_back(source + " - " + target, loss.second);
     }
 
     sort(res.begin(), res.end(), [](const std::pair<std::string,int>& a, const std::pair<std::string, int>& b){
@@ -455,30 +838,59 @@ std::vector<std::pair<std::string,int>> Supervisor::flowDifference(const Graph&
 }
 
 /**
- * This function calculates the max flow of each district/municipality and then orders it by descending flow, using the
- * superGraph that has a Super-Source (connected to all the vertexes with only 1 edge) and a Super-Sink connected to
- * each target station.\n\n
+ * This function finds the combinations of k segments whose simultaneous failure causes the largest loss of the total
+ * flow of the stations (N-k contingency analysis). Combinations are reported to onResult as soon as they enter the
+ * current top, so the caller can show them while the search goes on.\n\n
  *
- * @param graphType
- * @param _graph main graph
- * @param type 1 if the user wants municipality or 2 if district
+ * @param k number of segments that fail at the same time
+ * @param count number of combinations wanted
+ * @param onResult function called with each combination ("source - target + source - target") that enters the top
  *
- * @return Vector of pairs municipality/district and its max flow, ordered in descending order
+ * @return Vector of pairs combination and flow lost, ordered in descending order
  *
  * @par Time complexity
- * O(n * (V * E²)), where V is the number of vertexes and E the number of edges in the graph and n the size of municipality/district unordered maps
+ * O(C(S, k) * k * u * V * E² / p) in the worst case, where S is the number of segments, u the station flows that use
+ * each segment and p the threads; most combinations are pruned
  */
-std::vector<std::pair<std::string,int>> Supervisor::transportNeeds(bool graphType, const Graph& _graph, bool type){
-    auto _stations = type ? municipalityStations : districtStations;
+std::vector<std::pair<std::string, int>> Supervisor::criticalSegmentTuples(unsigned int k, unsigned int count,
+                                                                           const std::function<void(const std::string&, int)>& onResult) {
+    Contingency contingency(csr);
+    auto name = [this](const std::vector<int>& arcs) {
+        std::string res;
+        for (int arc : arcs) {
+            if (!res.empty()) res += " + ";
+            res += graph.findVertex(csr.getOrigin(arc))->getStation().getName() + " - "
+                 + graph.findVertex(csr.getTarget(arc))->getStation().getName();
+        }
+        return res;
+    };
 
     std::vector<std::pair<std::string, int>> res;
+    auto tuples = contingency.worstSegmentTuples(k, count, 0, [&name, &onResult](const std::vector<int>& arcs, int loss) {
+        if (onResult) onResult(name(arcs), loss);
+    });
+    for (const auto& tuple : tuples)
+        res.emplace_back(name(tuple.first), tuple.second);
 
-    for (const auto& pair : _stations){
-        createSuperGraph(graphType,_graph,pair.second);
+    return res;
+}
 
-        int maxFlow = superGraph.maxFlow(superGraphStations["Super-Source"],superGraphStations["Super-Sink"]);
-        res.emplace_back(pair.first,maxFlow);
-    }
+/**
+ * This function calculates, for every station of the network, how much of the total flow of the stations is lost
+ * if that station alone fails (N-1 contingency analysis), and orders the stations by descending loss. The sources
+ * are the line ends of the intact network (see Contingency), as in flowDifference.\n\n
+ *
+ * @return Vector of pairs station and flow lost, ordered in descending order
+ *
+ * @par Time complexity
+ * O(V * k * V * E² / p), where k is the number of station flows that use each station and p the threads
+ */
+std::vector<std::pair<std::string, int>> Supervisor::criticalStations() {
+    Contingency contingency(csr);
+    std::vector<std::pair<std::string, int>> res;
+
+    for (const auto& loss : contingency.stationLosses(0))
+        res.emplace_back(graph.findVertex(loss.first)->getStation().getName(), loss.second);
 
     sort(res.begin(), res.end(), [](const std::pair<std::string,int>& a, const std::pair<std::string, int>& b){
         return a.second > b.second;
@@ -487,115 +899,376 @@ std::vector<std::pair<std::string,int>> Supervisor::transportNeeds(bool graphTyp
     return res;
 }
 
+/**
+ * This function calculates the max flow of each district/municipality and then orders it by descending flow. The
+ * sources are the vertexes with only 1 edge outside the region and the sinks are the stations of the region, given
+ * to the multi-source multi-sink max flow of the graph.\n\n
+ * The flows are computed in parallel the first time they are needed, one copy of the network per thread, and saved
+ * next to the network keyed by its hash and by the hash of the regions of its stations, so later calls and later runs
+ * read them from the cache. Failures do not change them (they are always about the intact network); only a different
+ * network or different regions do. After a change of the network, only the regions connected to it are computed
+ * again, and nothing is saved: the changes are not stored, so the cache of the network read from the files is kept
+ * for the next run.\n\n
+ *
+ * @param type 1 if the user wants municipality or 0 if district
+ * @param k number of regions wanted (0 for all of them)
+ *
+ * @return Vector of the k pairs municipality/district with the largest max flow, ordered in descending order
+ *
+ * @par Time complexity
+ * O(1) when cached, otherwise O(n * V * E² / p), where V is the number of vertexes and E the number of edges in the
+ * graph, n the size of municipality/district unordered maps and p the threads
+ */
+std::vector<std::pair<std::string,int>> Supervisor::transportNeeds(bool type, unsigned int k){
+    if (!regionFlows.isValid(type)) {
+        const auto& regions = type ? municipalityStations : districtStations;
+        const auto& stale = regionFlows.getStale(type);
+        std::vector<std::pair<std::string, std::vector<int>>> ids;
+        for (const auto& region : regions)
+            if (stale.empty() || stale.find(region.first) != stale.end())
+                ids.emplace_back(region.first, stationIds(region.second));
+
+        unsigned int workers = std::max(1u, std::min(std::thread::hardware_concurrency(), (unsigned int) ids.size()));
+        std::vector<Graph> graphs;
+        for (unsigned int w = 0; w < workers; w++)
+            graphs.push_back(originalGraph());
+
+        regionFlows.compute(type, ids, graphs, lineEnds(graph));
+        if (changes.empty())
+            regionFlows.save(REGION_FLOWS, networkHash, regionHash);
+    }
+    const auto& flows = regionFlows.getFlows(type);
+    if (k == 0 || k > flows.size()) return flows;
+    return {flows.begin(), flows.begin() + k};
+}
+
+/**
+ * This function calculates the max flow from all the stations of a municipality/district to all the stations of
+ * another one, and its minimum cost, in a single multi-source multi-sink query on the main graph.\n\n
+ *
+ * @param from municipality/district where the trains leave from
+ * @param to municipality/district where the trains arrive
+ * @param municipality true for municipalities, false for districts
+ *
+ * @return Pair max flow and minimum cost of that flow
+ *
+ * @par Time complexity
+ * O(V * E² * log(V)), where V is the number of vertexes and E the number of edges in the graph
+ */
+std::pair<int, int> Supervisor::regionFlow(const std::string& from, const std::string& to, bool municipality){
+    const auto& regions = municipality ? municipalityStations : districtStations;
+    std::unordered_map<int, int> sources, sinks;
+    for (int id : stationIds(regions.at(from)))
+        sources[id] = INF;
+    for (int id : stationIds(regions.at(to)))
+        sinks[id] = INF;
+
+    int flow = graph.maxFlow(sources, sinks);
+    return {flow, graph.minCost(sources, sinks)};
+}
+
 /**
  * This function calculates the maximum number of connected stations in a municipality or district and orders them by descending order in
- * a vector.\n\n
- * @return Vector of pairs municipality/district and maximum connected components, ordered in descending order
+ * a vector, using the bitset sweeps of the CSR copy of the main graph.
+ * A region cannot have more connected stations than stations, so the regions are visited by descending size and the
+ * search stops once no region left can enter the top-k.\n\n
+ * @param type 1 if the user wants municipality or 0 if district
+ * @param k number of regions wanted (0 for all of them)
+ * @return Vector of the k pairs municipality/district with the most connected stations, ordered in descending order
  *
  * @par Time complexity
  * O(n * (V+E)), where V is the number of vertexes and E the number of edges and n the size of municipality/district unordered maps
  */
-std::vector<std::pair<std::string, int>> Supervisor::maxConnectedStations(int type) {
+std::vector<std::pair<std::string, int>> Supervisor::maxConnectedStations(int type, unsigned int k) {
+    const auto& regions = type ? municipalityStations : districtStations;
+    std::vector<std::pair<std::vector<int>, std::string>> order;
+    for (const auto& region: regions)
+        order.emplace_back(stationIds(region.second), region.first);
+    std::sort(order.begin(), order.end(), [](const std::pair<std::vector<int>, std::string>& a, const std::pair<std::vector<int>, std::string>& b){
+        return a.first.size() > b.first.size();
+    });
 
-    std::vector<std::pair<std::string, int>> res;
-    if (type)
-        for (const auto& municipality: municipalityStations)
-            res.emplace_back(municipality.first, graph.maxConnectedMunicipality(municipality.first));
-    else
-        for (const auto& district: districtStations)
-            res.emplace_back(district.first, graph.maxConnectedDistrict(district.first));
+    TopK<std::string, int> top(k);
+    for (const auto& region: order) {
+        if (!top.canEnter((int) region.first.size())) break;
+        top.push(region.second, (int) csr.largestComponent(csr.makeSet(region.first)));
+    }
 
-    sort(res.begin(), res.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b){
-        return a.second > b.second; });
+    return top.sorted();
+}
 
-    return res;
+/**
+ * @param municipality true for municipalities, false for districts
+ * @return Number of municipalities or districts
+ */
+unsigned int Supervisor::regionCount(bool municipality) const {
+    return municipality ? municipalityStations.size() : districtStations.size();
 }
 
 /**
- * This function adds a super source to the superGraph. It connects itself with all the vertexes/stations that have only 1 outgoing
- * edge.\n\n
+ * @param edge An edge of the main graph.
  *
- * @param id super source node id
- * @param targetStations unordered set with all the target stations
+ * @return The index of the edge in the CSR copies of the main graph, which keep the edges of each vertex in the same
+ * order.
  *
  * @par Time complexity
- * O(V), where V is the number of vertexes in the graph
+ * O(d), where d is the degree of the origin of the edge
  */
-void Supervisor::createSuperSource(int id, Station::StationH targetStations){
-    superGraph.addVertex(id, Station("Super-Source"));
-    superGraphStations["Super-Source"] = id;
-    for (auto v: graph.getVertexSet()){
-        if (targetStations.find(v->getStation()) != targetStations.end())
-            continue;
-        if (v->getAdj().size()==1)
-            superGraph.addEdge(id,v->getId(),INF,"");
+int Supervisor::segmentArc(const Edge* edge) const {
+    const std::vector<Edge*>& adj = edge->getOrig()->getAdj();
+    return csr.getArcs(edge->getOrig()->getId()).first + (int) (std::find(adj.begin(), adj.end(), edge) - adj.begin());
+}
+
+/**
+ * Finds the segment of the main network that a change refers to. Two stations can be linked by parallel segments
+ * (e.g. Funcheira and Santa Clara-Sabóia), which the names alone cannot tell apart, so a change of one of them must
+ * give its index among them; a change without an index is only accepted if there is a single segment.\n\n
+ *
+ * @param source The id of a station of the segment.
+ * @param target The id of the other station.
+ * @param parallel Index of the segment among the segments between the two stations, in the order they were read, or
+ * -1 if there must be only one; set to the index found.
+ *
+ * @return The edge from source to target, nullptr if there is no such segment or the choice is ambiguous.
+ *
+ * @par Time complexity
+ * O(d), where d is the degree of the source station
+ */
+Edge* Supervisor::findSegment(int source, int target, int& parallel) const {
+    if (parallel == -1) {
+        if (graph.segmentCount(source, target) != 1) return nullptr;
+        parallel = 0;
     }
+    if (parallel < 0) return nullptr;
+    return graph.findEdge(source, target, parallel);
 }
 
 /**
- * This function creates a super sink node and then connects it to all the target stations.\n\n
+ * Finds the stations whose results may change with a change of the network at some stations: the ones connected to
+ * them, by the trees of the bridge index (so it must be called before the change). The line ends that send flow to a
+ * station are always connected to it, so the flows of the other stations stay the same.\n\n
  *
- * @param id super sink id
- * @param targetStations unordered set containing all the stations that are needed
+ * @param ends The stations where the network changes.
+ *
+ * @return For each station, 1 if it is affected, 0 otherwise.
  *
  * @par Time complexity
  * O(V), where V is the number of vertexes in the graph
  */
-void Supervisor::createSuperSink(int id, Station::StationH targetStations){
+std::vector<char> Supervisor::affectedStations(const std::vector<int>& ends) const {
+    std::vector<char> trees(bridgeIndex.getComponentCount(), 0), affected(graph.getVertexSet().size(), 0);
+    for (int id : ends)
+        trees[bridgeIndex.getTree(id)] = 1;
+    for (unsigned int id = 0; id < affected.size(); id++)
+        affected[id] = trees[bridgeIndex.getTree((int) id)];
+    return affected;
+}
+
+/**
+ * Forgets the flows of the affected stations, which are calculated again when they are needed. When a segment only
+ * loses capacity, a station that sent no flow through it keeps its flow: the flow found is still valid and it cannot
+ * get larger.\n\n
+ *
+ * @param affected For each station, 1 if the change may affect it (see affectedStations).
+ * @param segment Index of the segment (as in getSegments) that lost capacity, -1 for any other change.
+ *
+ * @par Time complexity
+ * O(V * s), where V is the number of vertexes and s the number of segments used by the flow of a station
+ */
+void Supervisor::invalidateFlows(const std::vector<char>& affected, int segment) {
+    for (unsigned int id = 0; id < affected.size(); id++) {
+        if (!affected[id] || !flowReady[id]) continue;
+        if (segment != -1 && std::none_of(segmentFlows[id].begin(), segmentFlows[id].end(),
+                                          [segment](const std::pair<int, int>& flow) { return flow.first == segment; }))
+            continue;
+        flowReady[id] = 0;
+        segmentFlows[id].clear();
+    }
+}
 
-    std::vector<int> targets;
-    for (auto v: graph.getVertexSet())
-        if (targetStations.find(v->getStation()) != targetStations.end())
-            targets.push_back(v->getId());
+/**
+ * Updates what depends on the network after a change of capacity or of segments at the affected stations: the
+ * contracted graph, the hash of the network (so a flow matrix of the old network is no longer used) and the flows of
+ * the regions with affected stations, which are marked to be calculated again. The failure scenario was read from
+ * the network before the change, so it is cleared with its bridge index and contracted graph: the subgraph queries
+ * find no stations until setSubGraph is called again with a scenario read after the change.\n\n
+ *
+ * @param affected For each station, 1 if the change may affect it (see affectedStations).
+ *
+ * @par Time complexity
+ * O(V + E), where V is the number of vertexes and E the number of edges in the graph
+ */
+void Supervisor::networkChanged(const std::vector<char>& affected) {
+    contraction = ChainContraction(graph);
+    subGraph = Graph();
+    subBridgeIndex = BridgeIndex();
+    subContraction = ChainContraction();
+    networkHash = FlowMatrix::networkHash(graph);
+    flowMatrix.open(FLOW_MATRIX, networkHash);
+
+    std::unordered_set<std::string> municipalities, districts;
+    for (unsigned int id = 0; id < affected.size(); id++)
+        if (affected[id]) {
+            const Station& station = graph.findVertex((int) id)->getStation();
+            municipalities.insert(station.getMunicipality());
+            districts.insert(station.getDistrict());
+        }
+    regionFlows.invalidate(true, municipalities);
+    regionFlows.invalidate(false, districts);
+}
 
-    superGraphStations["Super-Sink"] = id;
-    superGraph.addVertex(id, Station("Super-Sink"));
+/**
+ * Updates what depends on the network after segments were added or removed at the affected stations. The CSR copies
+ * are made again from the main graph (the line ends may have changed), but the flows of the other stations are kept:
+ * their segments keep their position among the edges of their stations, so only their indexes are moved.\n\n
+ *
+ * @param affected For each station, 1 if the change may affect it (see affectedStations).
+ *
+ * @par Time complexity
+ * O(V * s + E), where V is the number of vertexes, E the number of edges and s the number of segments used by the
+ * flow of a station
+ */
+void Supervisor::topologyChanged(const std::vector<char>& affected) {
+    CsrGraph updated(graph);
+    {
+        std::lock_guard<std::mutex> guard(flowLock);
+        invalidateFlows(affected, -1);
+        for (auto& flows : segmentFlows)
+            for (auto& flow : flows) {
+                int v = csr.getOrigin(flow.first);
+                flow.first += updated.getArcs(v).first - csr.getArcs(v).first;
+            }
+        flowCsr = updated;
+        flowSegments = updated.getSegments();
+    }
+    csr = std::move(updated);
+    networkChanged(affected);
+}
 
-    for(auto i:targets)
-        superGraph.addEdge(i,id,INF,"");
+/**
+ * Changes the capacity of a segment of the main network (e.g. a temporary reduction), without reading the network
+ * again. Only the flows of the stations that may be affected are forgotten (see invalidateFlows); the bridge index
+ * and the landmarks do not depend on the capacities. The change is kept for the graphs read afterwards.\n\n
+ *
+ * @param source The name of a station of the segment.
+ * @param target The name of the other station.
+ * @param capacity The new capacity.
+ * @param parallel Index of the segment among the parallel segments between the two stations, in the order they were
+ * read (see findSegment); -1 if there is only one.
+ *
+ * @return True if the segment exists and was changed, false otherwise (also when the stations have parallel
+ * segments and none was chosen).
+ *
+ * @par Time complexity
+ * O(V * s + E), where V is the number of vertexes, E the number of edges and s the number of segments used by the
+ * flow of a station
+ */
+bool Supervisor::setSegmentCapacity(const std::string& source, const std::string& target, int capacity, int parallel) {
+    if (capacity < 0 || !idStations.count(source) || !idStations.count(target)) return false;
+    Edge* edge = findSegment(idStations.at(source), idStations.at(target), parallel);
+    if (edge == nullptr) return false;
+
+    std::vector<char> affected = affectedStations({edge->getOrig()->getId()});
+    int arc = segmentArc(edge);
+    int segment = capacity <= edge->getCapacity() ? std::min(arc, csr.getReverse(arc)) : -1;
+
+    changes.push_back({Change::CAPACITY, source, target, capacity, Service::NONE, 1, (unsigned int) parallel});
+    graph.setSegmentCapacity(edge, capacity);
+    csr.setSegmentCapacity(arc, capacity);
+    {
+        std::lock_guard<std::mutex> guard(flowLock);
+        flowCsr.setSegmentCapacity(arc, capacity);
+        invalidateFlows(affected, segment);
+    }
+    networkChanged(affected);
+    return true;
+}
 
+/**
+ * Adds a new segment between two stations of the main network, without reading the network again. The bridge index
+ * is updated in place, the landmarks are chosen again (a segment can make some costs smaller) and only the flows of
+ * the stations connected to its ends are forgotten. The change is kept for the graphs read afterwards.\n\n
+ *
+ * @param source The name of a station of the network.
+ * @param target The name of another station of the network.
+ * @param capacity The capacity of the segment.
+ * @param service The service of the segment.
+ * @param duration The number of time slots a train takes to cross it.
+ *
+ * @return True if the segment was added, false otherwise (unknown stations).
+ *
+ * @par Time complexity
+ * O(L * (V + E) * log(V) + V * s), where V is the number of vertexes, E the number of edges, L the number of
+ * landmarks and s the number of segments used by the flow of a station
+ */
+bool Supervisor::addSegment(const std::string& source, const std::string& target, int capacity, Service service, int duration) {
+    if (capacity < 0 || source == target || !idStations.count(source) || !idStations.count(target)) return false;
+    int a = idStations.at(source), b = idStations.at(target);
+    duration = std::min(65535, std::max(1, duration));
+
+    std::vector<char> affected = affectedStations({a, b});
+    changes.push_back({Change::ADD, source, target, capacity, service, duration, 0});
+    Edge* edge = graph.addEdge(a, b, capacity, service, duration);
+    bridgeIndex.addSegment(edge);
+    graph.buildLandmarks();
+    topologyChanged(affected);
+    return true;
 }
 
 /**
- * This function creates a graph  that  has a Super-Source connected to
- * all the stations that have only 1 outgoing edge and a Super-Sink connected to all stations in the targetStations.\n\n
+ * Removes a segment of the main network, without reading the network again. The bridge index is updated in place
+ * and only the flows of the stations connected to its ends are forgotten. The change is kept for the graphs read
+ * afterwards.\n\n
  *
- * @param type
- * @param _graph
- * @param targetStations unordered map containing all target stations
+ * @param source The name of a station of the segment.
+ * @param target The name of the other station.
+ * @param parallel Index of the segment among the parallel segments between the two stations, in the order they were
+ * read (see findSegment); -1 if there is only one.
+ *
+ * @return True if the segment exists and was removed, false otherwise (also when the stations have parallel segments
+ * and none was chosen).
  *
  * @par Time complexity
- * O(V), where V is the number of vertexes in the graph
+ * O(V * s + E), where V is the number of vertexes, E the number of edges and s the number of segments used by the
+ * flow of a station
  */
-void Supervisor::createSuperGraph(bool type, const Graph& _graph, const Station::StationH& targetStations){
-    superGraph = _graph;
-    superGraphStations = type ? idStations : subGraphStations;
-    int id = superGraphStations.size();
-    createSuperSource(id,targetStations);
-    createSuperSink(id+1,targetStations);
+bool Supervisor::removeSegment(const std::string& source, const std::string& target, int parallel) {
+    if (!idStations.count(source) || !idStations.count(target)) return false;
+    Edge* edge = findSegment(idStations.at(source), idStations.at(target), parallel);
+    if (edge == nullptr) return false;
+
+    std::vector<char> affected = affectedStations({edge->getOrig()->getId()});
+    changes.push_back({Change::REMOVE, source, target, 0, Service::NONE, 1, (unsigned int) parallel});
+    bridgeIndex.removeSegment(edge);
+    graph.removeSegment(edge);
+    topologyChanged(affected);
+    return true;
 }
 
 /**
- * This function creates a graph that only has a Super-Source connected to all
- * vertexes with only 1 outgoing edge.\n\n
+ * Closes a station of the main network: all its segments are removed and it is left isolated, like a station
+ * failure, without reading the network again. The change is kept for the graphs read afterwards.\n\n
  *
- * @param type
- * @param _graph
- * @param target
+ * @param station The name of the station.
+ *
+ * @return True if the station had segments and they were removed, false otherwise.
  *
  * @par Time complexity
- * O(V), where V is the number of vertexes in the graph
+ * O(d * (V + E) + V * s), where d is the degree of the station, V the number of vertexes, E the number of edges and
+ * s the number of segments used by the flow of a station
  */
-void Supervisor::createSuperSourceGraph(bool type, const Graph& _graph, int target){
-    superGraph = _graph;
-    superGraphStations = type ? idStations : subGraphStations;
-    int id = superGraphStations.size();
-    superGraph.addVertex(id, Station("Super-Source"));
-    superGraphStations["Super-Source"] = id;
-    for (auto v: superGraph.getVertexSet()){
-        if (v->getId() == target)
-            continue;
-        if (v->getAdj().size()==1)
-            superGraph.addEdge(id,v->getId(),INF,"");
+bool Supervisor::closeStation(const std::string& station) {
+    if (!idStations.count(station)) return false;
+    Vertex* vertex = graph.findVertex(idStations.at(station));
+    if (vertex->getAdj().empty()) return false;
+
+    std::vector<char> affected = affectedStations({vertex->getId()});
+    changes.push_back({Change::CLOSE, station, "", 0, Service::NONE, 1, 0});
+    std::vector<Edge*> segments = vertex->getAdj();
+    for (Edge* e : segments) {
+        bridgeIndex.removeSegment(e);
+        graph.removeSegment(e);
     }
-}
\ No newline at end of file
+    topologyChanged(affected);
+    return true;
+}
@@ -1,33 +1,51 @@
 #ifndef DA_SUPERVISOR_H
 #define DA_SUPERVISOR_H
 
-#include <fstream>
-#include <istream>
-#include <sstream>
 #include <iostream>
 #include <vector>
 #include <unordered_map>
 #include <list>
+#include <set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include "Graph.h"
+#include "BridgeIndex.h"
+#include "ChainContraction.h"
+#include "CsrGraph.h"
+#include "CsvReader.h"
+#include "Contingency.h"
+#include "FlowMatrix.h"
+#include "TimeExpandedGraph.h"
+#include "RegionFlows.h"
+#include "TopK.h"
+#include "CutTree.h"
+#include "KShortestPaths.h"
 
 class Supervisor{
 public:
 
     Supervisor();
+    ~Supervisor();
+
+    Supervisor(const Supervisor&) = delete;
+    Supervisor& operator=(const Supervisor&) = delete;
 
     //getters
-    Station::StationH getStations() const;
-    std::unordered_map<std::string, int> getId() const;
-    Graph getGraph() const;
-    Graph getSubGraph() const;
-    std::unordered_map<std::string, int> getSubGraphStations() const;
+    const Station::StationH& getStations() const;
+    const std::unordered_map<std::string, int>& getId() const;
+    const Graph& getGraph() const;
+    const Graph& getSubGraph() const;
+    const FlowMatrix& getFlowMatrix() const;
 
     void setSubGraph(const Graph& subgraph);
 
     //validate
     bool isStation(const std::string& station);
     bool isLine(const std::string& line);
+    bool isRegion(const std::string& region, bool municipality);
 
     Graph originalGraph();
 
@@ -35,35 +53,81 @@ public:
     Graph subgraph(const std::vector<std::pair<std::string, std::string>>& failedSegments);
     Graph subgraph(const Station::StationH& failedStations);
 
-    std::vector<std::pair<std::string, int>> maxConnectedStations(int type);
+    std::vector<std::pair<std::string, int>> maxConnectedStations(int type, unsigned int k = 0);
+    unsigned int regionCount(bool municipality) const;
+
+    std::vector<std::pair<int, int>> degradation(const std::vector<std::pair<std::string, std::string>>& segments, int percent);
+    std::vector<std::pair<int, int>> degradation(const std::unordered_set<std::string>& degradedLines, int percent);
+    std::vector<std::pair<int, int>> degradation(const std::string& region, bool municipality, int percent);
 
-    std::vector<std::pair<std::string, int>> flowDifference(const Graph& _subGraph);
+    std::vector<std::pair<std::string, int>> flowDifference(const Graph& _subGraph, unsigned int k = 0);
+    std::vector<std::pair<std::string, int>> flowDifference(const std::vector<std::pair<int, int>>& degraded, unsigned int k = 0);
 
-    std::vector<std::pair<std::string, int>> transportNeeds(bool graphType, const Graph& graph, bool type);
+    std::vector<std::pair<std::string, int>> criticalSegments();
+    std::vector<std::pair<std::string, int>> criticalStations();
+    std::vector<std::pair<std::string, int>> criticalSegmentTuples(unsigned int k, unsigned int count,
+                                                                   const std::function<void(const std::string&, int)>& onResult = nullptr);
+
+    std::vector<std::pair<std::string, int>> transportNeeds(bool type, unsigned int k = 0);
+    std::pair<int, int> regionFlow(const std::string& from, const std::string& to, bool municipality);
 
     int finalStationFlow(const Graph& _graph, int target);
 
+    int pairMaxFlow(bool subgraph, int source, int target);
+    std::vector<Edge *> bottleneck(bool subgraph, int source, int target);
+    std::vector<Route> routes(bool subgraph, int source, int target);
+    std::vector<Route> cheapestRoutes(bool subgraph, int source, int target, unsigned int k);
+    std::pair<int, int> timedFlow(int source, int target, int slots);
+
     int maxStationFlow(const std::string& station);
 
+    bool buildFlowMatrix(unsigned int threads);
+    int busiestPairs(std::vector<std::pair<int, int>>& pairs);
+
+    //network changes
+    bool setSegmentCapacity(const std::string& source, const std::string& target, int capacity, int parallel = -1);
+    bool addSegment(const std::string& source, const std::string& target, int capacity, Service service, int duration = 1);
+    bool removeSegment(const std::string& source, const std::string& target, int parallel = -1);
+    bool closeStation(const std::string& station);
+
 private:
 
+    struct Change {
+        enum Kind {ADD, CAPACITY, REMOVE, CLOSE} kind;
+        std::string source;
+        std::string target;
+        int capacity;
+        Service service;
+        int duration;
+        unsigned int parallel;
+    };
+
     void createStations();
     void stationsFlow();
+    int stationFlowOf(int id);
+
+    std::vector<int> stationIds(const Station::StationH& targetStations);
 
-    //graph variants
-    void createSuperSource(int id, Station::StationH targetStations);
-    void createSuperSink(int id, Station::StationH targetStations);
-    void createSuperGraph(bool type, const Graph& graph, const Station::StationH& targetStations);
-    void createSuperSourceGraph(bool type, const Graph& graph, int target);
+    static std::unordered_map<int, int> lineEnds(const Graph& _graph);
 
-    static void checkField(std::istringstream &iss, std::string &field);
-    static std::string removeQuotes(std::istringstream &iss, std::string field);
+    Graph readNetwork(const std::function<bool(const std::string&, const std::string&)> &failure);
 
-    int makeVertex(Graph &_graph, std::unordered_map<std::string, int> &ids, const std::string &name, int &id);
+    int makeVertex(Graph &_graph, const std::string &name);
+
+    void applyChange(Graph& _graph, const Change& change, const std::function<bool(const std::string&, const std::string&)>& failure);
+    int segmentArc(const Edge* edge) const;
+    Edge* findSegment(int source, int target, int& parallel) const;
+    std::vector<char> affectedStations(const std::vector<int>& ends) const;
+    void invalidateFlows(const std::vector<char>& affected, int segment);
+    void topologyChanged(const std::vector<char>& affected);
+    void networkChanged(const std::vector<char>& affected);
+
+    std::vector<std::pair<int, int>> degradation(const std::function<bool(int, int)>& degraded, int percent) const;
+    std::vector<std::pair<std::string, int>> lossRanking(const std::vector<std::pair<int, int>>& capacities, const Graph& _graph, unsigned int k);
 
     static bool segmentFailure(const std::vector<std::pair<std::string, std::string>>& failedSegments, const std::string& source, const std::string& target);
-    bool lineFailure(std::unordered_set<std::string> failedLines, const std::string &source, const std::string &target);
-    static bool stationFailure(Station::StationH failedStations, const std::string &source, const std::string &target);
+    bool lineFailure(const std::unordered_set<std::string> &failedLines, const std::string &source, const std::string &target);
+    static bool stationFailure(const Station::StationH &failedStations, const std::string &source, const std::string &target);
 
     Station::StationH stations;
     std::unordered_map<std::string, int> idStations;
@@ -71,16 +135,34 @@ private:
     std::unordered_map<std::string, Station::StationH> municipalityStations;
     std::unordered_map<std::string, Station::StationH> districtStations;
 
-    std::unordered_map<std::string, int> subGraphStations;
-    std::unordered_map<std::string, int> superGraphStations;
-
     std::unordered_set<std::string> lines;
 
-    std::unordered_map<std::string, int> stationFlow;
+    std::vector<Change> changes;
+
+    std::vector<int> stationFlow;
+    std::vector<std::vector<std::pair<int, int>>> segmentFlows;
+    std::vector<char> flowReady;
+    std::vector<int> flowSegments;
+    CsrGraph flowCsr;
+    std::mutex flowLock;
+    std::atomic<bool> stopWarming{false};
+    std::thread warmer;
 
     Graph graph;
     Graph subGraph;
-    Graph superGraph;
+
+    BridgeIndex bridgeIndex;
+    BridgeIndex subBridgeIndex;
+
+    ChainContraction contraction;
+    ChainContraction subContraction;
+
+    CsrGraph csr;
+
+    uint64_t networkHash = 0;
+    uint64_t regionHash = 0;
+    FlowMatrix flowMatrix;
+    RegionFlows regionFlows;
 };
 
 #endif //DA_SUPERVISOR_H
@@ -0,0 +1,400 @@
+#include "TimeExpandedGraph.h"
+
+#include <queue>
+#include <unordered_map>
+
+TimeExpandedGraph::TimeExpandedGraph() = default;
+
+/**
+ * Builds the time-expanded network of a graph over a horizon of time slots. Each station has one copy per slot and
+ * a segment that takes d slots to cross links (v, t) to (w, t + d), with the capacity of the segment (trains that can
+ * depart in one slot) and the cost of its service. Trains can also wait at a station, from (v, t) to (v, t + 1),
+ * without limit and for free.\n\n
+ * The copies are implicit: only the segments are stored, once, and a copy is the pair (station, slot). The only data
+ * kept per slot is the flow of each segment and of each wait, so the memory is O(T * (V + E)) integers instead of T
+ * copies of the vertexes and edges.\n\n
+ *
+ * @param graph The network, with the duration of each segment (see Edge::getDuration).
+ * @param slots Number of time slots of the horizon.
+ *
+ * @par Time complexity
+ * O(T * (V + E)), where T is the number of slots, V the number of vertexes and E the number of edges in the graph
+ */
+TimeExpandedGraph::TimeExpandedGraph(const Graph& graph, int slots): slots(std::max(1, slots)) {
+    const std::vector<Vertex*>& vertexSet = graph.getVertexSet();
+    n = (int) vertexSet.size();
+
+    std::vector<std::vector<Edge*>> adj;
+    for (Vertex* v : vertexSet)
+        adj.push_back(v->getAdj());
+
+    offset.assign(n + 1, 0);
+    for (int v = 0; v < n; v++)
+        offset[v + 1] = offset[v] + (int) adj[v].size();
+    m = offset[n];
+
+    target.assign(m, 0);
+    reverse.assign(m, 0);
+    capacity.assign(m, 0);
+    cost.assign(m, 0);
+    duration.assign(m, 1);
+
+    std::unordered_map<const Edge*, int> arc;
+    for (int v = 0, i = 0; v < n; v++)
+        for (Edge* e : adj[v]) {
+            arc[e] = i;
+            target[i] = e->getDest()->getId();
+            capacity[i] = e->getCapacity();
+            cost[i] = e->getCost();
+            duration[i] = std::max(1, e->getDuration());
+            i++;
+        }
+    for (int v = 0; v < n; v++)
+        for (Edge* e : adj[v])
+            reverse[arc[e]] = arc[e->getReverse()];
+
+    travelFlow.assign((size_t) this->slots * m, 0);
+    waitFlow.assign((size_t) this->slots * n, 0);
+    level.assign((size_t) this->slots * n, -1);
+    cursor.assign((size_t) this->slots * n, 0);
+}
+
+/**
+ * @return Number of time slots of the horizon.
+ */
+int TimeExpandedGraph::getSlots() const {
+    return slots;
+}
+
+/**
+ * @return Value of the flow found by the last maxFlow or minCost.
+ */
+int TimeExpandedGraph::getFlowValue() const {
+    return flowValue;
+}
+
+/**
+ * @return Identifier of the copy of station v in slot t.
+ */
+int TimeExpandedGraph::node(int v, int t) const {
+    return t * n + v;
+}
+
+/**
+ * A move through the time-expanded network is encoded as (index << 2) | kind, where index is t * E + arc for
+ * the segments and t * V + station for the waits, t being the slot where the move starts when it is done forwards.\n\n
+ *
+ * @param code A move.
+ *
+ * @return The copy where the move starts.
+ */
+int TimeExpandedGraph::previous(int code) const {
+    int index = code >> 2;
+    switch (code & 3) {
+        case TRAVEL: return node(target[reverse[index % m]], index / m);
+        case TRAVEL_BACK: return node(target[index % m], index / m + duration[index % m]);
+        case WAIT: return index;
+        default: return index + n;
+    }
+}
+
+/**
+ * @param code A move.
+ *
+ * @return How many trains can still make the move: the capacity left of a segment, the flow that can be cancelled
+ * when going backwards, or INF for a wait.
+ */
+int TimeExpandedGraph::residual(int code) const {
+    int index = code >> 2;
+    switch (code & 3) {
+        case TRAVEL: return capacity[index % m] - travelFlow[index];
+        case TRAVEL_BACK: return travelFlow[index];
+        case WAIT: return INF;
+        default: return waitFlow[index];
+    }
+}
+
+/**
+ * @param code A move.
+ *
+ * @return Cost of one train making the move (negative when a segment is crossed backwards, cancelling its flow).
+ */
+int TimeExpandedGraph::moveCost(int code) const {
+    switch (code & 3) {
+        case TRAVEL: return cost[(code >> 2) % m];
+        case TRAVEL_BACK: return -cost[(code >> 2) % m];
+        default: return 0;
+    }
+}
+
+/**
+ * @param x The copy of a station.
+ *
+ * @return Number of moves that may start at the copy: departing through or cancelling each of its segments, waiting
+ * and cancelling a wait.
+ */
+int TimeExpandedGraph::moveCount(int x) const {
+    int v = x % n;
+    return 2 * (offset[v + 1] - offset[v]) + 2;
+}
+
+/**
+ * Finds the k-th move that may start at a copy, if it has residual capacity: departing through a segment, cancelling
+ * the flow of a segment that arrived at it, waiting one slot or cancelling the wait that arrived at it.\n\n
+ *
+ * @param x The copy of a station.
+ * @param k Index of the move, smaller than moveCount(x).
+ * @param y Where the copy reached by the move is stored.
+ *
+ * @return The move, or -1 if it cannot be made.
+ *
+ * @par Time complexity
+ * O(1)
+ */
+int TimeExpandedGraph::moveAt(int x, int k, int& y) const {
+    int v = x % n, t = x / n;
+    int degree = offset[v + 1] - offset[v];
+    if (k < 2 * degree) {
+        int a = offset[v] + k / 2;
+        if (k % 2 == 0) {
+            if (t + duration[a] >= slots || capacity[a] - travelFlow[(size_t) t * m + a] <= 0) return -1;
+            y = node(target[a], t + duration[a]);
+            return ((t * m + a) << 2) | TRAVEL;
+        }
+        int back = reverse[a];
+        int departure = t - duration[back];
+        if (departure < 0 || travelFlow[(size_t) departure * m + back] <= 0) return -1;
+        y = node(target[a], departure);
+        return ((departure * m + back) << 2) | TRAVEL_BACK;
+    }
+    if (k == 2 * degree) {
+        if (t + 1 >= slots) return -1;
+        y = x + n;
+        return (x << 2) | WAIT;
+    }
+    if (t == 0 || waitFlow[x - n] <= 0) return -1;
+    y = x - n;
+    return ((x - n) << 2) | WAIT_BACK;
+}
+
+/**
+ * Checks if a move can be part of a blocking flow: it must go one level further and, when only the cheapest paths
+ * are wanted, have reduced cost 0 (see updatePotentials).
+ */
+bool TimeExpandedGraph::admissible(int x, int y, int code, bool cheapest) const {
+    if (level[y] != level[x] + 1) return false;
+    return !cheapest || moveCost(code) + potential[x] - potential[y] == 0;
+}
+
+/**
+ * Computes the BFS level (number of moves from the source) of every copy, using only the moves with residual
+ * capacity and, when only the cheapest paths are wanted, reduced cost 0.\n\n
+ *
+ * @param src The copy where the trains depart.
+ * @param dest The copy where the trains arrive.
+ * @param cheapest True to use only the moves of the cheapest paths.
+ *
+ * @return True if the destination was reached, false otherwise.
+ *
+ * @par Time complexity
+ * O(T * (V + E)), where T is the number of slots, V the number of vertexes and E the number of edges in the graph
+ */
+bool TimeExpandedGraph::findLevels(int src, int dest, bool cheapest) {
+    std::fill(level.begin(), level.end(), -1);
+    std::queue<int> q;
+    level[src] = 0;
+    q.push(src);
+
+    while (!q.empty()) {
+        int x = q.front();
+        q.pop();
+        if (level[dest] != -1 && level[x] >= level[dest]) break;
+        for (int k = 0, count = moveCount(x); k < count; k++) {
+            int y, code = moveAt(x, k, y);
+            if (code == -1 || level[y] != -1) continue;
+            if (cheapest && moveCost(code) + potential[x] - potential[y] != 0) continue;
+            level[y] = level[x] + 1;
+            q.push(y);
+        }
+    }
+    return level[dest] != -1;
+}
+
+/**
+ * Sends a blocking flow through the levels found by findLevels, with an iterative DFS that remembers, for every copy,
+ * the next move to try, so each move is discarded at most once.\n\n
+ *
+ * @param src The copy where the trains depart.
+ * @param dest The copy where the trains arrive.
+ * @param cheapest True to use only the moves of the cheapest paths.
+ *
+ * @return The number of trains sent.
+ *
+ * @par Time complexity
+ * O(T * (V + E) * L), where L is the number of moves of the paths and T, V, E as above
+ */
+int TimeExpandedGraph::blockingFlow(int src, int dest, bool cheapest) {
+    std::fill(cursor.begin(), cursor.end(), 0);
+    std::vector<int> path;
+    int total = 0, x = src;
+
+    while (true) {
+        if (x == dest) {
+            int f = INF;
+            for (int code : path)
+                f = std::min(f, residual(code));
+            for (int code : path)
+                push(code, f);
+            total += f;
+
+            unsigned int i = 0;
+            while (residual(path[i]) > 0) i++;
+            x = previous(path[i]);
+            path.resize(i);
+            continue;
+        }
+
+        bool advanced = false;
+        for (int count = moveCount(x); cursor[x] < count; cursor[x]++) {
+            int y, code = moveAt(x, cursor[x], y);
+            if (code == -1 || !admissible(x, y, code, cheapest)) continue;
+            path.push_back(code);
+            x = y;
+            advanced = true;
+            break;
+        }
+        if (advanced) continue;
+
+        if (x == src) break;
+        level[x] = -1;
+        x = previous(path.back());
+        path.pop_back();
+        cursor[x]++;
+    }
+    return total;
+}
+
+/**
+ * Adds trains to a move (or removes them, when it cancels flow).\n\n
+ *
+ * @param code A move.
+ * @param f Number of trains.
+ */
+void TimeExpandedGraph::push(int code, int f) {
+    int index = code >> 2;
+    switch (code & 3) {
+        case TRAVEL: travelFlow[index] += f; break;
+        case TRAVEL_BACK: travelFlow[index] -= f; break;
+        case WAIT: waitFlow[index] += f; break;
+        default: waitFlow[index] -= f; break;
+    }
+}
+
+/**
+ * Finds the cost of the cheapest path from the source to every copy with Dijkstra's algorithm on the reduced costs
+ * (cost + potential of the start - potential of the end), which are never negative, and adds it to the potentials.
+ * Afterwards the moves of the cheapest paths are exactly the ones with reduced cost 0.\n\n
+ *
+ * @param src The copy where the trains depart.
+ * @param dest The copy where the trains arrive.
+ *
+ * @return True if the destination can be reached, false otherwise.
+ *
+ * @par Time complexity
+ * O(T * (V + E) * log(T * V)), where T is the number of slots, V the number of vertexes and E the number of edges
+ */
+bool TimeExpandedGraph::updatePotentials(int src, int dest) {
+    const long long unreached = std::numeric_limits<long long>::max();
+    std::fill(distance.begin(), distance.end(), unreached);
+
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> q;
+    distance[src] = 0;
+    q.emplace(0, src);
+
+    while (!q.empty()) {
+        auto [d, x] = q.top();
+        q.pop();
+        if (d != distance[x]) continue;
+        for (int k = 0, count = moveCount(x); k < count; k++) {
+            int y, code = moveAt(x, k, y);
+            if (code == -1) continue;
+            long long candidate = d + moveCost(code) + potential[x] - potential[y];
+            if (candidate < distance[y]) {
+                distance[y] = candidate;
+                q.emplace(candidate, y);
+            }
+        }
+    }
+
+    for (size_t x = 0; x < distance.size(); x++)
+        if (distance[x] != unreached) potential[x] += distance[x];
+    return distance[dest] != unreached;
+}
+
+/**
+ * Removes all the flow.
+ */
+void TimeExpandedGraph::reset() {
+    std::fill(travelFlow.begin(), travelFlow.end(), 0);
+    std::fill(waitFlow.begin(), waitFlow.end(), 0);
+    flowValue = 0;
+}
+
+/**
+ * Finds the maximum number of trains that can depart from a station and arrive at another within the horizon, with
+ * Dinic's algorithm (a blocking flow per BFS instead of a single path, since a long horizon carries many trains). The trains depart from the first slot of the source (waiting there is free, so they
+ * may leave later) and are counted at the last slot of the target.\n\n
+ *
+ * @param source The identifier of the source station.
+ * @param target The identifier of the target station.
+ *
+ * @return The maximum number of trains, or 0 if the target cannot be reached within the horizon.
+ *
+ * @par Time complexity
+ * O(L² * T * (V + E)), where L is the number of moves of the longest path, T the number of slots, V the number of
+ * vertexes and E the number of edges
+ */
+int TimeExpandedGraph::maxFlow(int source, int target) {
+    reset();
+    if (source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return 0;
+
+    int src = node(source, 0), dest = node(target, slots - 1);
+    while (findLevels(src, dest, false))
+        flowValue += blockingFlow(src, dest, false);
+    return flowValue;
+}
+
+/**
+ * Finds the minimum total cost of sending the maximum number of trains between two stations within the horizon, with
+ * the primal-dual algorithm: each round finds the cost of the cheapest paths and sends a blocking flow through all of
+ * them at once. Every segment crossed by a train costs the cost of its service; waiting is free. The number of trains
+ * is available afterwards in getFlowValue.\n\n
+ *
+ * @param source The identifier of the source station.
+ * @param target The identifier of the target station.
+ *
+ * @return The total cost of all the trains, or 0 if the target cannot be reached within the horizon.
+ *
+ * @par Time complexity
+ * O(C * T * (V + E) * (log(T * V) + L²)), where C is the number of different path costs, L the number of moves of the
+ * longest path, T the number of slots, V the number of vertexes and E the number of edges
+ */
+int TimeExpandedGraph::minCost(int source, int target) {
+    reset();
+    if (source < 0 || target < 0 || source >= n || target >= n || source == target)
+        return 0;
+
+    distance.assign((size_t) slots * n, 0);
+    potential.assign((size_t) slots * n, 0);
+
+    int src = node(source, 0), dest = node(target, slots - 1);
+    long long total = 0;
+    while (updatePotentials(src, dest))
+        while (findLevels(src, dest, true)) {
+            int f = blockingFlow(src, dest, true);
+            flowValue += f;
+            total += (long long) f * (potential[dest] - potential[src]);
+        }
+    return (int) std::min<long long>(total, INF);
+}
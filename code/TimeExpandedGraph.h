@@ -0,0 +1,58 @@
+#ifndef DA_TIMEEXPANDEDGRAPH_H
+#define DA_TIMEEXPANDEDGRAPH_H
+
+#include <vector>
+
+#include "Graph.h"
+
+class TimeExpandedGraph {
+public:
+    TimeExpandedGraph();
+    TimeExpandedGraph(const Graph& graph, int slots);
+
+    int maxFlow(int source, int target);
+    int minCost(int source, int target);
+
+    int getSlots() const;
+    int getFlowValue() const;
+
+private:
+    int n = 0;
+    int m = 0;
+    int slots = 0;
+    int flowValue = 0;
+
+    std::vector<int> offset;
+    std::vector<int> target;
+    std::vector<int> reverse;
+    std::vector<int> capacity;
+    std::vector<int> cost;
+    std::vector<int> duration;
+
+    std::vector<int> travelFlow;
+    std::vector<int> waitFlow;
+
+    std::vector<int> level;
+    std::vector<int> cursor;
+    std::vector<long long> distance;
+    std::vector<long long> potential;
+
+    enum Move { TRAVEL, TRAVEL_BACK, WAIT, WAIT_BACK };
+
+    int node(int v, int t) const;
+    int previous(int code) const;
+    int residual(int code) const;
+    int moveCost(int code) const;
+
+    int moveCount(int x) const;
+    int moveAt(int x, int k, int& y) const;
+    void push(int code, int f);
+
+    bool admissible(int x, int y, int code, bool cheapest) const;
+    bool findLevels(int src, int dest, bool cheapest);
+    int blockingFlow(int src, int dest, bool cheapest);
+    bool updatePotentials(int src, int dest);
+    void reset();
+};
+
+#endif //DA_TIMEEXPANDEDGRAPH_H
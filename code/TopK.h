@@ -0,0 +1,79 @@
+#ifndef DA_TOPK_H
+#define DA_TOPK_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+/**
+ * Streaming selection of the k items with the largest values. The items are kept in a min-heap of size k, so an item
+ * that does not beat the k-th value is discarded in O(1) and every other one costs O(log(k)). When an upper bound of
+ * the value of an item is known before computing it, canEnter tells if it is worth computing at all: if the items
+ * are offered by descending bound, the first one that cannot enter ends the search.
+ * Ties on the k-th value are kept by order of arrival. With k = 0 every item is kept.
+ */
+template <typename Key, typename Value>
+class TopK {
+public:
+    explicit TopK(size_t k): k(k == 0 ? std::numeric_limits<size_t>::max() : k) {}
+
+    /**
+     * @return True if there are k items, false otherwise.
+     */
+    bool full() const {
+        return heap.size() >= k;
+    }
+
+    /**
+     * @param bound An upper bound of the value of an item.
+     *
+     * @return True if an item with that value would be kept, false otherwise.
+     *
+     * @par Time complexity
+     * O(1)
+     */
+    bool canEnter(Value bound) const {
+        return !full() || heap.front().second < bound;
+    }
+
+    /**
+     * Offers an item, which is kept if it is among the k largest seen so far.\n\n
+     *
+     * @param key The item.
+     * @param value Its value.
+     *
+     * @par Time complexity
+     * O(log(k))
+     */
+    void push(const Key& key, Value value) {
+        if (!canEnter(value)) return;
+        if (full()) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            heap.pop_back();
+        }
+        heap.emplace_back(key, value);
+        std::push_heap(heap.begin(), heap.end(), greater);
+    }
+
+    /**
+     * @return The items kept, ordered by descending value.
+     *
+     * @par Time complexity
+     * O(k * log(k))
+     */
+    std::vector<std::pair<Key, Value>> sorted() const {
+        std::vector<std::pair<Key, Value>> res = heap;
+        std::sort_heap(res.begin(), res.end(), greater);
+        return res;
+    }
+
+private:
+    size_t k;
+    std::vector<std::pair<Key, Value>> heap;
+
+    static bool greater(const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) {
+        return a.second > b.second;
+    }
+};
+
+#endif //DA_TOPK_H
@@ -4,18 +4,29 @@
 
 Vertex::Vertex(int id): id(id) {}
 
-Edge * Vertex::addEdge(Vertex *d, int capacity, const std::string& service) {
+Edge * Vertex::addEdge(Vertex *d, int capacity, Service service) {
     Edge* newEdge = new Edge(this, d, capacity, service);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
     return newEdge;
 }
 
+void Vertex::removeEdge(Edge *edge) {
+    adj.erase(std::find(adj.begin(), adj.end(), edge));
+    auto& in = edge->getDest()->incoming;
+    in.erase(std::find(in.begin(), in.end(), edge));
+    delete edge;
+}
+
+/**
+ * Order of the vertexes in the priority queue: by path cost plus the lower bound of the cost left to the target,
+ * which is 0 except in goal-directed searches.
+ */
 bool Vertex::operator<(Vertex & vertex) const {
-    return this->pathCost < vertex.pathCost;
+    return this->pathCost + this->lowerBound < vertex.pathCost + vertex.lowerBound;
 }
 
-Station Vertex::getStation() const {
+const Station& Vertex::getStation() const {
     return this->station;
 }
 
@@ -23,7 +34,7 @@ int Vertex::getId() const {
     return this->id;
 }
 
-std::vector<Edge*> Vertex::getAdj() const {
+const std::vector<Edge*>& Vertex::getAdj() const {
     return this->adj;
 }
 
@@ -31,14 +42,26 @@ bool Vertex::isVisited() const {
     return this->visited;
 }
 
+bool Vertex::isSinkVisited() const {
+    return this->sinkVisited;
+}
+
 int Vertex::getPathCost() const {
     return this->pathCost;
 }
 
+int Vertex::getLowerBound() const {
+    return this->lowerBound;
+}
+
 Edge *Vertex::getPath() const {
     return this->path;
 }
 
+Edge *Vertex::getNext() const {
+    return this->next;
+}
+
 void Vertex::setVisited(bool visited) {
     this->visited = visited;
 }
@@ -47,21 +70,33 @@ void Vertex::setPathCost(int pathCost) {
     this->pathCost = pathCost;
 }
 
+void Vertex::setLowerBound(int lowerBound) {
+    this->lowerBound = lowerBound;
+}
+
 void Vertex::setPath(Edge *path) {
     this->path = path;
 }
 
+void Vertex::setNext(Edge *next) {
+    this->next = next;
+}
+
+void Vertex::setSinkVisited(bool sinkVisited) {
+    this->sinkVisited = sinkVisited;
+}
+
 void Vertex::setStation(Station station) {
     this->station = station;
 }
 
 /********************** Edge  ****************************/
 
-Edge::Edge(Vertex *orig, Vertex *dest, int capacity, const std::string& service): orig(orig), dest(dest), capacity(capacity), service(service) {
-    if (service == "STANDARD")
-        this->cost = 2;
-    else if (service == "ALFA PENDULAR")
-        this->cost = 4;
+Edge::Edge(Vertex *orig, Vertex *dest, int capacity, Service service): dest(dest), orig(orig), capacity(capacity),
+    cost(serviceInfo(service).cost), service(service) {}
+
+void Edge::setCapacity(int capacity) {
+    this->capacity = capacity;
 }
 
 void Edge::setResidualCapacity(int residualCapacity) {
@@ -76,6 +111,22 @@ int Edge::getCost() const{
     return this->cost;
 }
 
+Service Edge::getService() const {
+    return this->service;
+}
+
+void Edge::setCost(int cost) {
+    this->cost = cost;
+}
+
+int Edge::getDuration() const {
+    return this->duration;
+}
+
+void Edge::setDuration(int duration) {
+    this->duration = duration;
+}
+
 Vertex * Edge::getDest() const {
     return this->dest;
 }
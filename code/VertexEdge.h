@@ -8,6 +8,7 @@
 #include <algorithm>
 
 #include "Station.h"
+#include "Service.h"
 
 class Edge;
 
@@ -20,19 +21,26 @@ public:
     bool operator<(Vertex& vertex) const;
 
     int getId() const;
-    std::vector<Edge *> getAdj() const;
+    const std::vector<Edge *>& getAdj() const;
 
     int getPathCost() const;
+    int getLowerBound() const;
     Edge *getPath() const;
-    Station getStation() const;
+    Edge *getNext() const;
+    const Station& getStation() const;
 
     void setStation(Station station);
     void setVisited(bool visited);
     void setPathCost(int pathCost);
+    void setLowerBound(int lowerBound);
     void setPath(Edge *path);
+    void setNext(Edge *next);
+    void setSinkVisited(bool sinkVisited);
 
     bool isVisited() const;
-    Edge * addEdge(Vertex *dest, int capacity, const std::string& service);
+    bool isSinkVisited() const;
+    Edge * addEdge(Vertex *dest, int capacity, Service service);
+    void removeEdge(Edge *edge);
 
     int queueIndex = 0;
 
@@ -42,7 +50,10 @@ private:
     std::vector<Edge *> incoming;
     bool visited = false;
     int pathCost = 0;
+    int lowerBound = 0;
     Edge *path = nullptr;
+    bool sinkVisited = false;
+    Edge *next = nullptr;
     Station station = Station("");
 };
 
@@ -50,7 +61,7 @@ private:
 
 class Edge {
 public:
-    Edge(Vertex *orig, Vertex *dest, int capacity, const std::string& service);
+    Edge(Vertex *orig, Vertex *dest, int capacity, Service service);
 
     Vertex * getDest() const;
     int getCapacity() const;
@@ -60,18 +71,24 @@ public:
     Edge *getReverse() const;
 
     int getCost() const;
+    Service getService() const;
+    int getDuration() const;
 
     void setReverse(Edge *reverse);
+    void setCapacity(int capacity);
     void setResidualCapacity(int residualCapacity);
+    void setCost(int cost);
+    void setDuration(int duration);
 
 private:
     Vertex * dest;
     Vertex *orig;
+    Edge *reverse = nullptr;
     int capacity;
-    int residualCapacity;
+    int residualCapacity = 0;
     int cost;
-    std::string service;
-    Edge *reverse = nullptr;
+    Service service;
+    unsigned short duration = 1;
 };
 
 #endif //DA_VERTEXEDGE_H
@@ -1,7 +1,13 @@
 #include "Menu.h"
+#include "Batch.h"
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        Supervisor supervisor;
+        return Batch(&supervisor).run(std::vector<std::string>(argv + 1, argv + argc));
+    }
 
-int main() {
     Menu menu;
     menu.init();
     Menu::end();
-}
\ No newline at end of file
+}